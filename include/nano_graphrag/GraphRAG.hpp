@@ -1,21 +1,33 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <filesystem>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_set>
 
 #include "nano_graphrag/embedding/base.hpp"
 #include "nano_graphrag/embedding/factory.hpp"
+#include "nano_graphrag/embedding/cached.hpp"
+#include "nano_graphrag/embedding/truncated.hpp"
+#include "nano_graphrag/llm/cached.hpp"
 #include "nano_graphrag/operations/tokenize/base.hpp"
 #include "nano_graphrag/operations/tokenize/factory.hpp"
 #include "nano_graphrag/operations/chunking/default.hpp"
 #include "nano_graphrag/operations/chunking/factory.hpp"
+#include "nano_graphrag/operations/chunking/streaming.hpp"
+#include "nano_graphrag/operations/dedup/minhash.hpp"
 #include "nano_graphrag/storage/base.hpp"
 #include "nano_graphrag/storage/JsonKVStorage.hpp"
 #include "nano_graphrag/storage/GraphStorage.hpp"
 #include "nano_graphrag/storage/NanoVectorDBStorage.hpp"
+#include "nano_graphrag/storage/TokenCache.hpp"
 #include "nano_graphrag/llm/base.hpp"
 #include "nano_graphrag/llm/factory.hpp"
 #include "nano_graphrag/utils/Prompts.hpp"
@@ -38,6 +50,8 @@ public:
   int chunk_overlap_token_size{ 100 };
   std::shared_ptr<ITokenizerStrategy> tokenizer;
   std::unique_ptr<DefaultChunkingStrategy> chunker;
+  std::unique_ptr<MinHashDeduplicator> near_dedup;  // optional, see enable_near_dedup
+  std::shared_ptr<TokenCache> token_cache;          // tokenization sidecar, see enable_token_cache
 
   // storage
   std::unique_ptr<BaseKVStorage<std::unordered_map<std::string, std::string>>> full_docs;
@@ -66,10 +80,13 @@ public:
     community_reports = std::make_unique<JsonKVStorage<Community>>("community_reports", cfg);
     chunk_entity_relation_graph = std::make_unique<InMemoryGraphStorage>("chunk_entity_relation", cfg);
 
-    // Defaults: Tiktoken tokenizer if available, else Simple
+    // Defaults: Tiktoken tokenizer if available, else Simple. The BPE tables are shared process-wide
+    // and loaded in the background, so construction does not wait for them.
     tokenizer = create_tokenizer_strategy(TokenizerType::Tiktoken);
     if (!tokenizer)
       tokenizer = create_tokenizer_strategy(TokenizerType::Simple);
+    else
+      prewarm_tiktoken_encoding(LanguageModel::O200K_BASE);
     chunker = std::make_unique<DefaultChunkingStrategy>();
     chunker->set_tokenizer(tokenizer);
     chunker->set_chunk_size(chunk_token_size);
@@ -82,10 +99,100 @@ public:
   {
     embedding_strategy = std::move(s);
   }
+  /**
+   * @brief Wrap the embedding strategy in a persistent `CachedEmbeddingStrategy` in `working_dir`
+   *
+   * Chunks embedded before (by any namespace using the same model and dimension)
+   * are not sent to the model again. Call after `set_embedding_strategy`; the
+   * naive-RAG vector store is switched over too. A strategy without a model
+   * name is left uncached, since its vectors could not be told apart from
+   * another model's.
+   */
+  void enable_embedding_cache()
+  {
+    // the cache sits under a truncation, so it keeps full-size vectors
+    auto truncated = std::dynamic_pointer_cast<TruncatedEmbeddingStrategy>(embedding_strategy);
+    std::shared_ptr<IEmbeddingStrategy> base = truncated ? truncated->inner() : embedding_strategy;
+    if (!base || std::dynamic_pointer_cast<CachedEmbeddingStrategy>(base))
+      return;
+    if (base->model_name().empty())
+    {
+      debug_log("[GraphRAG] embedding cache not enabled: the strategy has no model name");
+      return;
+    }
+    base = std::make_shared<CachedEmbeddingStrategy>(base, working_dir);
+    embedding_strategy =
+        truncated ? std::make_shared<TruncatedEmbeddingStrategy>(base, truncated->embedding_dim()) : base;
+    if (chunks_vdb)
+      chunks_vdb->embedding_strategy = embedding_strategy;
+    if (entities_vdb)
+      entities_vdb->embedding_strategy = embedding_strategy;
+    debug_log("[GraphRAG] embedding cache enabled");
+  }
+  /**
+   * @brief Serve embeddings at `dim` components through a `TruncatedEmbeddingStrategy`
+   *
+   * For Matryoshka models (text-embedding-3) the renormalized prefix keeps most
+   * of the recall at a fraction of the index memory and scan time. The
+   * truncation wraps the embedding cache, which keeps full-size vectors, so a
+   * dimension change re-embeds from the cache. The naive-RAG vector store is
+   * recreated at the new dimension; `reindex()` refills it. An entity vector
+   * store holding another dimension is recreated empty in the same way; one that
+   * is not a `NanoVectorDBStorage` cannot be, so the call throws
+   * `std::logic_error` and changes nothing. 0 restores the full size.
+   */
+  void set_embedding_dimensions(size_t dim)
+  {
+    std::shared_ptr<IEmbeddingStrategy> next = embedding_strategy;
+    if (auto truncated = std::dynamic_pointer_cast<TruncatedEmbeddingStrategy>(next))
+      next = truncated->inner();
+    if (!next)
+      return;
+    if (dim > 0 && dim != next->embedding_dim())
+      next = std::make_shared<TruncatedEmbeddingStrategy>(next, dim);
+    if (entities_vdb && entities_vdb->embedding_strategy &&
+        entities_vdb->embedding_strategy->embedding_dim() != next->embedding_dim())
+    {
+      // vectors stored at the old dimension cannot be mixed with new ones
+      if (!dynamic_cast<NanoVectorDBStorage*>(entities_vdb.get()))
+        throw std::logic_error("set_embedding_dimensions: entities_vdb holds vectors of another dimension");
+      auto meta_fields = entities_vdb->meta_fields;
+      auto ns = entities_vdb->namespace_name;
+      entities_vdb = std::make_unique<NanoVectorDBStorage>(ns, entities_vdb->global_config, next);
+      entities_vdb->meta_fields = std::move(meta_fields);
+    }
+    embedding_strategy = next;
+    if (entities_vdb)
+      entities_vdb->embedding_strategy = embedding_strategy;
+    if (enable_naive_rag)
+      enable_naive(true);
+    debug_log("[GraphRAG] embedding dim=", embedding_strategy->embedding_dim());
+  }
   void set_llm_strategy(std::shared_ptr<ILLMStrategy> s)
   {
     llm_strategy = std::move(s);
   }
+  /**
+   * @brief Wrap the LLM strategy in a `CachedLLMStrategy` stored in `working_dir`
+   *
+   * Repeated (model, system prompt, user prompt) triples, e.g. re-run queries
+   * or indexing stages, are answered from `llm_response_cache.json` without a
+   * model call. Call after `set_llm_strategy`.
+   *
+   * @param ttl Max age of a cached completion; zero keeps them forever
+   */
+  void enable_llm_cache(std::chrono::seconds ttl = std::chrono::seconds{ 0 })
+  {
+    if (auto cached = std::dynamic_pointer_cast<CachedLLMStrategy>(llm_strategy))
+    {
+      cached->set_ttl(ttl);
+      return;
+    }
+    if (!llm_strategy)
+      return;
+    llm_strategy = std::make_shared<CachedLLMStrategy>(llm_strategy, working_dir, ttl);
+    debug_log("[GraphRAG] llm cache enabled ttl=", ttl.count(), "s");
+  }
   void set_chat_model(const std::string& m)
   {
     chat_model = m;
@@ -95,6 +202,22 @@ public:
     tokenizer = create_tokenizer_strategy(type);
     if (chunker)
       chunker->set_tokenizer(tokenizer);
+    if (token_cache)
+      enable_token_cache(true);
+  }
+  void set_chunking_strategy(ChunkingStrategyType type)
+  {
+    const size_t threads = chunker ? chunker->num_threads() : 0;
+    if (type == ChunkingStrategyType::Separator)
+      chunker = std::make_unique<SeparatorChunkingStrategy>();
+    else
+      chunker = std::make_unique<DefaultChunkingStrategy>();
+    chunker->set_tokenizer(tokenizer);
+    chunker->set_chunk_size(chunk_token_size);
+    chunker->set_overlap_size(chunk_overlap_token_size);
+    chunker->set_token_cache(token_cache);
+    if (threads)
+      chunker->set_num_threads(threads);
   }
   void set_chunk_params(int max_tokens, int overlap_tokens)
   {
@@ -107,6 +230,64 @@ public:
     }
   }
 
+  /**
+   * @brief Keep each document's tokenization in a binary sidecar in `working_dir`
+   *
+   * The file is named after the tokenizer (`token_cache_<name>.bin`) and entries
+   * are keyed by document hash, so `reindex()` and inserts of known documents
+   * skip the tokenizer. Off by default; enable it before inserting documents that
+   * will be re-chunked.
+   *
+   * @param enabled False detaches the cache (the file is kept)
+   */
+  void enable_token_cache(bool enabled = true)
+  {
+    token_cache.reset();
+    if (enabled && tokenizer)
+    {
+      const std::string name = tokenizer->name();
+      token_cache = std::make_shared<TokenCache>(working_dir + "/token_cache_" + name + ".bin", name);
+      debug_log("[GraphRAG] token cache ", token_cache->path(), " entries=", token_cache->size());
+    }
+    if (chunker)
+      chunker->set_token_cache(token_cache);
+  }
+
+  void set_chunking_threads(size_t n)
+  {
+    if (chunker)
+      chunker->set_num_threads(n);
+  }
+
+  /**
+   * @brief Link near-duplicate chunks instead of embedding them again
+   *
+   * Chunks whose estimated Jaccard similarity (MinHash over word shingles) to an
+   * already indexed chunk reaches `threshold` are stored with `duplicate_of` set
+   * and are not upserted into the vector index. The detector is seeded with the
+   * chunks already in `text_chunks`.
+   *
+   * @param threshold Jaccard similarity in (0, 1]; values <= 0 disable detection
+   */
+  void enable_near_dedup(double threshold = 0.8)
+  {
+    if (threshold <= 0.0)
+    {
+      near_dedup.reset();
+      return;
+    }
+    MinHashParam param;
+    param.threshold = threshold;
+    near_dedup = std::make_unique<MinHashDeduplicator>(param);
+    auto keys = text_chunks->all_keys();
+    std::sort(keys.begin(), keys.end());
+    auto existing = text_chunks->get_by_ids(keys);
+    for (size_t i = 0; i < keys.size(); ++i)
+      if (existing[i].has_value() && existing[i]->duplicate_of.empty())
+        near_dedup->add(keys[i], existing[i]->content);
+    debug_log("[GraphRAG] near dedup enabled threshold=", threshold, ", seeded=", near_dedup->size());
+  }
+
   void enable_naive(bool v)
   {
     enable_naive_rag = v;
@@ -137,8 +318,12 @@ public:
     if (chunker)
     {
       inserting_chunks = chunker->get_chunks(new_docs, chunk_overlap_token_size, chunk_token_size);
+      if (token_cache)
+        token_cache->flush();
     }
     debug_log("[GraphRAG] chunks produced=", inserting_chunks.size());
+    if (near_dedup)
+      mark_near_duplicates(inserting_chunks);
 
     // upsert vector DB for naive
     if (enable_naive_rag && chunks_vdb)
@@ -147,7 +332,8 @@ public:
       std::unordered_map<std::string, std::unordered_map<std::string, std::string>> vdb_data;
       for (const auto& kv : inserting_chunks)
       {
-        vdb_data[kv.first] = { { "content", kv.second.content } };
+        if (kv.second.duplicate_of.empty())
+          vdb_data[kv.first] = { { "content", kv.second.content } };
       }
       chunks_vdb->upsert(vdb_data);
     }
@@ -158,6 +344,99 @@ public:
     debug_log("[GraphRAG] insert completed");
   }
 
+  /**
+   * @brief Insert one document read incrementally from a stream
+   *
+   * Chunks are produced by `StreamingChunker` and stored in batches, so memory
+   * stays proportional to the chunk size and `batch_chunks` rather than the
+   * document size. The full text is not kept in `full_docs`; its entry only
+   * records the chunk count.
+   *
+   * @param in Input stream, read until EOF
+   * @param doc_id Document id used as each chunk's `full_doc_id`
+   * @param batch_chunks Chunks buffered before each storage upsert
+   * @return Number of chunks produced
+   */
+  size_t insert_stream(std::istream& in, const std::string& doc_id, size_t batch_chunks = 256)
+  {
+    debug_log("[GraphRAG] insert_stream doc=", doc_id);
+    StreamingChunker streaming(tokenizer, chunk_token_size, chunk_overlap_token_size);
+    std::unordered_map<std::string, TextChunk> batch;
+    auto flush = [this, &batch]() {
+      if (batch.empty())
+        return;
+      if (near_dedup)
+        mark_near_duplicates(batch);
+      if (enable_naive_rag && chunks_vdb)
+      {
+        std::unordered_map<std::string, std::unordered_map<std::string, std::string>> vdb_data;
+        for (const auto& kv : batch)
+          if (kv.second.duplicate_of.empty())
+            vdb_data[kv.first] = { { "content", kv.second.content } };
+        chunks_vdb->upsert(vdb_data);
+      }
+      text_chunks->upsert(batch);
+      batch.clear();
+    };
+    std::hash<std::string> h;
+    size_t produced = streaming.chunk_stream(in, doc_id, [&](TextChunk&& chunk) {
+      std::string id = "chunk-" + std::to_string(h(chunk.content));
+      batch.emplace(std::move(id), std::move(chunk));
+      if (batch.size() >= batch_chunks)
+        flush();
+    });
+    flush();
+    full_docs->upsert({ { doc_id, { { "streamed", "true" }, { "chunks", std::to_string(produced) } } } });
+    debug_log("[GraphRAG] insert_stream chunks produced=", produced);
+    return produced;
+  }
+
+  /**
+   * @brief Re-chunk every stored document with the current chunking settings
+   *
+   * Use after `set_chunk_params` or `set_chunking_strategy`. `text_chunks` is
+   * replaced; with `enable_token_cache()` documents are re-tokenized only if
+   * missing from the token cache. With naive RAG enabled the new chunks are
+   * upserted into `chunks_vdb`; vectors of chunks that no longer exist stay in
+   * the index and are skipped at query time. Streamed documents (see
+   * `insert_stream`) are not kept in full and are left out.
+   *
+   * @return Number of chunks produced
+   */
+  size_t reindex()
+  {
+    auto keys = full_docs->all_keys();
+    std::sort(keys.begin(), keys.end());
+    auto stored = full_docs->get_by_ids(keys);
+    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> docs;
+    for (size_t i = 0; i < keys.size(); ++i)
+      if (stored[i].has_value() && stored[i]->count("content"))
+        docs[keys[i]] = { { "content", stored[i]->at("content") } };
+    debug_log("[GraphRAG] reindex docs=", docs.size(), ", chunk_size=", chunk_token_size,
+              ", overlap=", chunk_overlap_token_size);
+
+    auto chunks = chunker->get_chunks(docs, chunk_overlap_token_size, chunk_token_size);
+    if (token_cache)
+      token_cache->flush();
+    text_chunks->drop();
+    if (near_dedup)
+    {
+      near_dedup = std::make_unique<MinHashDeduplicator>(near_dedup->param());
+      mark_near_duplicates(chunks);
+    }
+    if (enable_naive_rag && chunks_vdb)
+    {
+      std::unordered_map<std::string, std::unordered_map<std::string, std::string>> vdb_data;
+      for (const auto& kv : chunks)
+        if (kv.second.duplicate_of.empty())
+          vdb_data[kv.first] = { { "content", kv.second.content } };
+      chunks_vdb->upsert(vdb_data);
+    }
+    text_chunks->upsert(chunks);
+    debug_log("[GraphRAG] reindex chunks produced=", chunks.size());
+    return chunks.size();
+  }
+
   std::string query(const std::string& q, const QueryParam& param = QueryParam{})
   {
     if (param.mode == "naive")
@@ -170,6 +449,60 @@ public:
   }
 
 private:
+  // Set duplicate_of on chunks that are near-duplicates of indexed ones, in id order so results are
+  // deterministic. Chunks already stored under the same id are left alone.
+  void mark_near_duplicates(std::unordered_map<std::string, TextChunk>& chunks)
+  {
+    std::vector<std::string> ids;
+    ids.reserve(chunks.size());
+    for (const auto& kv : chunks)
+      ids.push_back(kv.first);
+    std::sort(ids.begin(), ids.end());
+    auto fresh = text_chunks->filter_keys(ids);
+    std::unordered_set<std::string> is_new(fresh.begin(), fresh.end());
+    size_t linked = 0;
+    for (const auto& id : ids)
+    {
+      if (!is_new.count(id))
+        continue;
+      auto& chunk = chunks.at(id);
+      if (auto dup = near_dedup->check_and_add(id, chunk.content))
+      {
+        chunk.duplicate_of = *dup;
+        ++linked;
+      }
+    }
+    debug_log("[GraphRAG] near-duplicate chunks linked=", linked);
+  }
+
+  // Join chunks with a separator until the token budget is reached. Stored chunk token counts are used
+  // when present; the separators and chunks without a count are measured with the tokenizer.
+  std::string build_chunk_section(const std::vector<std::optional<TextChunk>>& chunks, int max_tokens,
+                                  int& tokens) const
+  {
+    static const std::string kSeparator = "\n--New Chunk--\n";
+    const int separator_tokens = tokenizer ? static_cast<int>(tokenizer->count_tokens(kSeparator)) : 0;
+    std::string section;
+    tokens = 0;
+    for (const auto& optChunk : chunks)
+    {
+      if (!optChunk.has_value())
+        continue;
+      const auto& c = optChunk.value();
+      int chunk_tokens = c.tokens;
+      if (chunk_tokens <= 0 && tokenizer)
+        chunk_tokens = static_cast<int>(tokenizer->count_tokens(c.content));
+      int needed = chunk_tokens + (section.empty() ? 0 : separator_tokens);
+      if (tokens + needed > max_tokens)
+        break;
+      tokens += needed;
+      if (!section.empty())
+        section += kSeparator;
+      section += c.content;
+    }
+    return section;
+  }
+
   // Naive: top-k chunks, no doc restriction
   std::string naive_query(const std::string& q, const QueryParam& param)
   {
@@ -186,20 +519,8 @@ private:
     for (auto& r : results)
       ids.push_back(r["id"]);
     auto chunks = text_chunks->get_by_ids(ids);
-    std::string section;
     int tokens = 0;
-    for (const auto& optChunk : chunks)
-    {
-      if (!optChunk.has_value())
-        continue;
-      const auto& c = optChunk.value();
-      tokens += c.tokens;
-      if (tokens > param.naive_max_token_for_text_unit)
-        break;
-      section += c.content + "\n--New Chunk--\n";
-    }
-    if (!section.empty())
-      section.erase(section.size() - std::string("\n--New Chunk--\n").size());
+    std::string section = build_chunk_section(chunks, param.naive_max_token_for_text_unit, tokens);
     debug_log("[GraphRAG] context tokens=", tokens);
     if (param.only_need_context)
       return section;
@@ -246,17 +567,8 @@ private:
         break;
     }
     auto chunks = text_chunks->get_by_ids(ids);
-    std::string section;
     int tokens = 0;
-    for (const auto& optChunk : chunks) {
-      if (!optChunk.has_value()) continue;
-      const auto& c = optChunk.value();
-      tokens += c.tokens;
-      if (tokens > param.naive_max_token_for_text_unit) break;
-      section += c.content + "\n--New Chunk--\n";
-    }
-    if (!section.empty())
-      section.erase(section.size() - std::string("\n--New Chunk--\n").size());
+    std::string section = build_chunk_section(chunks, param.naive_max_token_for_text_unit, tokens);
     debug_log("[GraphRAG] local context tokens=", tokens);
     if (param.only_need_context)
       return section;
@@ -292,17 +604,8 @@ private:
     for (const auto& kv : doc_top_chunk)
       ids.push_back(kv.second);
     auto chunks = text_chunks->get_by_ids(ids);
-    std::string section;
     int tokens = 0;
-    for (const auto& optChunk : chunks) {
-      if (!optChunk.has_value()) continue;
-      const auto& c = optChunk.value();
-      tokens += c.tokens;
-      if (tokens > param.naive_max_token_for_text_unit) break;
-      section += c.content + "\n--New Chunk--\n";
-    }
-    if (!section.empty())
-      section.erase(section.size() - std::string("\n--New Chunk--\n").size());
+    std::string section = build_chunk_section(chunks, param.naive_max_token_for_text_unit, tokens);
     debug_log("[GraphRAG] global context tokens=", tokens);
     if (param.only_need_context)
       return section;
@@ -1,10 +1,59 @@
 // Abstract base class for embedding strategies
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 namespace nano_graphrag
 {
 
+/**
+ * @brief Embeddings of a batch as one contiguous row-major `rows x dim` matrix
+ *
+ * One allocation for the whole batch instead of one per vector; rows can be
+ * handed to a vector index without further copies.
+ */
+struct EmbeddingMatrix
+{
+  size_t rows{ 0 };
+  size_t dim{ 0 };
+  std::vector<float> values;  // rows * dim
+
+  EmbeddingMatrix() = default;
+  EmbeddingMatrix(size_t r, size_t d) : rows(r), dim(d), values(r * d, 0.0f)
+  {
+  }
+
+  /**
+   * @brief Reshape to `r x d`, zero-filled; keeps the allocation when it is large enough
+   */
+  void resize(size_t r, size_t d)
+  {
+    rows = r;
+    dim = d;
+    values.assign(r * d, 0.0f);
+  }
+
+  float* row(size_t i)
+  {
+    return values.data() + i * dim;
+  }
+  const float* row(size_t i) const
+  {
+    return values.data() + i * dim;
+  }
+
+  /**
+   * @brief Copy out as one vector per row
+   */
+  std::vector<std::vector<float>> to_vectors() const
+  {
+    std::vector<std::vector<float>> out(rows);
+    for (size_t i = 0; i < rows; ++i)
+      out[i].assign(row(i), row(i) + dim);
+    return out;
+  }
+};
+
 /**
  * @brief Abstract base class for embedding strategies
  */
@@ -23,6 +72,36 @@ public:
    */
   virtual std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const = 0;
 
+  /**
+   * @brief Embed `texts` into `out`, reshaped to `texts.size() x embedding_dim()`
+   *
+   * The default adapts `embed()`; strategies that decode into contiguous memory
+   * override it to skip the per-vector allocations. Rows the strategy did not
+   * produce are zero; longer vectors are cut to the matrix width.
+   * @param texts The input texts
+   * @param out Destination matrix; its allocation is reused across calls
+   */
+  virtual void embed_into(const std::vector<std::string>& texts, EmbeddingMatrix& out) const
+  {
+    std::vector<std::vector<float>> vectors = embed(texts);
+    size_t dim = embedding_dim();
+    if (dim == 0 && !vectors.empty())
+      dim = vectors.front().size();
+    out.resize(texts.size(), dim);
+    for (size_t i = 0; i < vectors.size() && i < out.rows; ++i)
+      std::copy_n(vectors[i].data(), std::min(dim, vectors[i].size()), out.row(i));
+  }
+
+  /**
+   * @brief Embed `texts` into a new matrix, see `embed_into`
+   */
+  EmbeddingMatrix embed_matrix(const std::vector<std::string>& texts) const
+  {
+    EmbeddingMatrix out;
+    embed_into(texts, out);
+    return out;
+  }
+
   /**
    * @brief Optionally: expose embedding dimension and max token size
    * @return The embedding dimension
@@ -34,6 +113,17 @@ public:
    * @return The max token size
    */
   virtual size_t max_token_size() const = 0;
+
+  /**
+   * @brief Optionally: expose model name
+   *
+   * Identifies the vector space; caches key stored embeddings by it.
+   * @return The model name, or an empty string if unknown
+   */
+  virtual std::string model_name() const
+  {
+    return std::string();
+  }
 };
 
 }  // namespace nano_graphrag
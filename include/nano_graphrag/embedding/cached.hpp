@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nano_graphrag/embedding/base.hpp"
+#include "nano_graphrag/utils/Hash.hpp"
+#include "nano_graphrag/utils/Log.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Decorator that keeps a persistent, content-addressed cache of another strategy's embeddings
+ *
+ * Vectors are keyed by a 128-bit hash of the text and stored in a file per
+ * (model, dimension) pair, `<dir>/embedding_cache_<model>_<dim>.bin`, so caches
+ * for different models never mix. The model name is the only identity of the
+ * vector space, so a strategy that does not report one cannot be cached.
+ * `embed` looks the whole batch up, forwards only the misses (each distinct
+ * text once) to the wrapped strategy, and appends the new vectors to the file
+ * before returning.
+ *
+ * The file is a short header followed by fixed-size records: the 16-byte key
+ * and `dim` raw floats. Only the key index is held in memory; hits are read back
+ * from the file. A truncated trailing record is dropped on load.
+ *
+ * All methods are thread-safe.
+ */
+class CachedEmbeddingStrategy : public IEmbeddingStrategy
+{
+public:
+  /**
+   * @brief Wrap `inner`, caching in directory `dir`
+   *
+   * @param inner Strategy that computes the embeddings on a miss
+   * @param dir Directory for the cache file (created on first write)
+   * @throws std::invalid_argument if `inner` reports no model name
+   */
+  CachedEmbeddingStrategy(std::shared_ptr<IEmbeddingStrategy> inner, const std::string& dir)
+    : inner_(std::move(inner))
+  {
+    if (!inner_)
+      throw std::invalid_argument("CachedEmbeddingStrategy requires an inner strategy");
+    model_ = inner_->model_name();
+    if (model_.empty())
+      throw std::invalid_argument("CachedEmbeddingStrategy requires an inner strategy with a model name");
+    dim_ = inner_->embedding_dim();
+    std::string safe_model = model_;
+    for (char& c : safe_model)
+      if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.')
+        c = '_';
+    path_ = dir + "/embedding_cache_" + safe_model + "_" + std::to_string(dim_) + ".bin";
+    load();
+  }
+
+  std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const override
+  {
+    return embed_matrix(texts).to_vectors();
+  }
+
+  void embed_into(const std::vector<std::string>& texts, EmbeddingMatrix& out) const override
+  {
+    out.resize(texts.size(), dim_);
+    std::vector<Key> keys(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i)
+      keys[i] = key(texts[i]);
+
+    // distinct missing texts, and for each input the miss it waits on
+    std::vector<std::string> miss_texts;
+    std::vector<Key> miss_keys;
+    std::vector<std::pair<size_t, size_t>> waiting;  // (input index, miss index)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unordered_map<Key, size_t, KeyHash> miss_index;
+      for (size_t i = 0; i < texts.size(); ++i)
+      {
+        auto it = index_.find(keys[i]);
+        if (it != index_.end() && read_record(it->second, out.row(i)))
+        {
+          ++hits_;
+          continue;
+        }
+        ++misses_;
+        auto inserted = miss_index.emplace(keys[i], miss_texts.size());
+        if (inserted.second)
+        {
+          miss_texts.push_back(texts[i]);
+          miss_keys.push_back(keys[i]);
+        }
+        waiting.emplace_back(i, inserted.first->second);
+      }
+    }
+    if (miss_texts.empty())
+      return;
+
+    debug_log("[CachedEmbedding] hits=", texts.size() - waiting.size(), ", forwarding=", miss_texts.size());
+    EmbeddingMatrix computed;
+    inner_->embed_into(miss_texts, computed);
+    if (computed.rows != miss_texts.size())
+      throw std::runtime_error("inner embedding strategy returned " + std::to_string(computed.rows) +
+                               " vectors for " + std::to_string(miss_texts.size()) + " texts");
+    const size_t width = std::min(dim_, computed.dim);
+    for (const auto& w : waiting)
+      std::copy_n(computed.row(w.second), width, out.row(w.first));
+    if (computed.dim == dim_)
+      append(miss_keys, computed);  // wrong-sized vectors are returned but not cached
+  }
+
+  size_t embedding_dim() const override
+  {
+    return dim_;
+  }
+  size_t max_token_size() const override
+  {
+    return inner_->max_token_size();
+  }
+  std::string model_name() const override
+  {
+    return model_;
+  }
+
+  /** Number of cached vectors. */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+  }
+
+  /** Inputs answered from the cache since construction. */
+  size_t hits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /** Inputs that had to be computed (before in-batch deduplication) since construction. */
+  size_t misses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  /** `hits / (hits + misses)`, or 0 before the first lookup. */
+  double hit_rate() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_ + misses_ ? static_cast<double>(hits_) / static_cast<double>(hits_ + misses_) : 0.0;
+  }
+
+  const std::string& path() const
+  {
+    return path_;
+  }
+
+  const std::shared_ptr<IEmbeddingStrategy>& inner() const
+  {
+    return inner_;
+  }
+
+private:
+  struct Key
+  {
+    uint64_t lo;
+    uint64_t hi;
+    bool operator==(const Key& o) const
+    {
+      return lo == o.lo && hi == o.hi;
+    }
+  };
+  struct KeyHash
+  {
+    size_t operator()(const Key& k) const
+    {
+      return static_cast<size_t>(k.lo);
+    }
+  };
+
+  static constexpr char kMagic[4] = { 'N', 'G', 'E', 'C' };
+  static constexpr uint32_t kVersion = 1;
+
+  static Key key(std::string_view text)
+  {
+    return Key{ hash_bytes64(text, 0x243F6A8885A308D3ull), hash_bytes64(text, 0x13198A2E03707344ull) };
+  }
+
+  size_t record_bytes() const
+  {
+    return sizeof(Key) + dim_ * sizeof(float);
+  }
+
+  std::string header() const
+  {
+    std::string h(kMagic, sizeof(kMagic));
+    const uint32_t fields[3] = { kVersion, static_cast<uint32_t>(dim_),
+                                 static_cast<uint32_t>(model_.size()) };
+    h.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+    h += model_;
+    return h;
+  }
+
+  // Caller holds mutex_
+  bool read_record(uint64_t record, float* out) const
+  {
+    if (!reader_.is_open())
+      reader_.open(path_, std::ios::binary);
+    reader_.clear();
+    reader_.seekg(static_cast<std::streamoff>(data_begin_ + record * record_bytes() + sizeof(Key)));
+    const auto bytes = static_cast<std::streamsize>(dim_ * sizeof(float));
+    return static_cast<bool>(reader_.read(reinterpret_cast<char*>(out), bytes));
+  }
+
+  void append(const std::vector<Key>& keys, const EmbeddingMatrix& vectors) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto dir = std::filesystem::path(path_).parent_path();
+    if (!dir.empty())
+      std::filesystem::create_directories(dir);
+    std::string buf;
+    if (!header_ok_)
+    {
+      reader_.close();
+      buf = header();
+    }
+    std::vector<std::pair<Key, uint64_t>> added;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      if (index_.count(keys[i]))
+        continue;
+      buf.append(reinterpret_cast<const char*>(&keys[i]), sizeof(Key));
+      buf.append(reinterpret_cast<const char*>(vectors.row(i)), dim_ * sizeof(float));
+      added.emplace_back(keys[i], records_ + added.size());
+    }
+    if (added.empty())
+      return;
+    std::ofstream out(path_, std::ios::binary | (header_ok_ ? std::ios::app : std::ios::trunc));
+    if (!out.write(buf.data(), static_cast<std::streamsize>(buf.size())).flush())
+      return;
+    if (!header_ok_)
+    {
+      header_ok_ = true;
+      data_begin_ = header().size();
+    }
+    for (const auto& a : added)
+      index_.emplace(a.first, a.second);
+    records_ += added.size();
+  }
+
+  void load()
+  {
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(path_, ec);
+    std::ifstream in(path_, std::ios::binary);
+    if (ec || !in)
+      return;
+    const std::string expected = header();
+    std::string got(expected.size(), '\0');
+    if (!in.read(&got[0], static_cast<std::streamsize>(got.size())) || got != expected)
+      return;  // other format or model: replaced on the first write
+    header_ok_ = true;
+    data_begin_ = expected.size();
+    const uint64_t count = (size - data_begin_) / record_bytes();
+    for (uint64_t r = 0; r < count; ++r)
+    {
+      Key k;
+      in.seekg(static_cast<std::streamoff>(data_begin_ + r * record_bytes()));
+      if (!in.read(reinterpret_cast<char*>(&k), sizeof(k)))
+        break;
+      index_.emplace(k, r);
+      records_ = r + 1;
+    }
+    const uint64_t valid_end = data_begin_ + records_ * record_bytes();
+    if (valid_end != size)
+    {
+      in.close();
+      std::filesystem::resize_file(path_, valid_end, ec);
+    }
+  }
+
+  std::shared_ptr<IEmbeddingStrategy> inner_;
+  std::string model_;
+  size_t dim_{ 0 };
+  std::string path_;
+  mutable std::mutex mutex_;
+  mutable std::ifstream reader_;
+  mutable std::unordered_map<Key, uint64_t, KeyHash> index_;  // key -> record number
+  mutable uint64_t records_{ 0 };
+  mutable uint64_t data_begin_{ 0 };
+  mutable bool header_ok_{ false };
+  mutable size_t hits_{ 0 };
+  mutable size_t misses_{ 0 };
+};
+
+}  // namespace nano_graphrag
@@ -2,6 +2,7 @@
 #include <memory>
 #include "nano_graphrag/embedding/base.hpp"
 #include "nano_graphrag/embedding/openai.hpp"
+#include "nano_graphrag/embedding/local.hpp"
 #include "nano_graphrag/embedding/hash.hpp"
 
 namespace nano_graphrag
@@ -11,11 +12,13 @@ namespace nano_graphrag
  * @brief Enum for different embedding strategy types
  *
  * @param OpenAI OpenAI embedding strategy
+ * @param Local Offline hashed n-gram embeddings, see `LocalEmbeddingStrategy`
  */
 enum class EmbeddingStrategyType
 {
   OpenAI,
   Hash,
+  Local,
   // Add more strategies here
 };
 
@@ -31,6 +34,8 @@ inline std::unique_ptr<IEmbeddingStrategy> create_embedding_strategy(EmbeddingSt
   {
     case EmbeddingStrategyType::OpenAI:
       return std::make_unique<OpenAIEmbeddingStrategy>();
+    case EmbeddingStrategyType::Local:
+      return std::make_unique<LocalEmbeddingStrategy>();
     // Add more cases here
     default:
       return nullptr;
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nano_graphrag/embedding/base.hpp"
+#include "nano_graphrag/utils/Hash.hpp"
+#include "nano_graphrag/utils/Parallel.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief CPU-only embeddings from hashed word and character n-gram features
+ *
+ * Each text is split into words (runs of ASCII letters and digits, plus any
+ * non-ASCII bytes; ASCII is lower-cased). Every word contributes a word feature
+ * and the character n-grams of `<word>` for n in `[ngram_min, ngram_max]`,
+ * fastText style, so inflections and typos still overlap. Features are hashed
+ * and added through a sparse random projection: each one adds +-weight to
+ * `kProjections` components chosen by its hash. The result is L2-normalized.
+ *
+ * Vectors are deterministic for a given (dimension, n-gram range, seed), need
+ * no model files or network, and cost a few hundred nanoseconds per word. They
+ * capture lexical rather than semantic similarity. They are meant for offline
+ * runs, CI and throughput tests of the storage and query pipeline, or as a
+ * keyword-style retriever for air-gapped deployments.
+ */
+class LocalEmbeddingStrategy : public IEmbeddingStrategy
+{
+public:
+  LocalEmbeddingStrategy(size_t dim = 256, size_t max_tokens = 8192)
+    : embedding_dim_(std::max<size_t>(dim, 1)), max_token_size_(max_tokens)
+  {
+  }
+
+  std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const override
+  {
+    return embed_matrix(texts).to_vectors();
+  }
+
+  void embed_into(const std::vector<std::string>& texts, EmbeddingMatrix& out) const override
+  {
+    out.resize(texts.size(), embedding_dim_);
+    // small batches (e.g. a single query) are not worth a thread start
+    const size_t threads = texts.size() < kMinParallelBatch ? 1 : num_threads_;
+    parallel_for(0, texts.size(), threads, [&](size_t lo, size_t hi, size_t) {
+      for (size_t i = lo; i < hi; ++i)
+        embed_text(texts[i], out.row(i));
+    });
+  }
+
+  /**
+   * @brief Character n-gram lengths (default 3 to 5); `min == 0` keeps word features only
+   */
+  void set_ngram_range(size_t min, size_t max)
+  {
+    ngram_min_ = min;
+    ngram_max_ = std::max(min, max);
+  }
+
+  /**
+   * @brief Seed of the feature hashing; different seeds give unrelated vector spaces
+   */
+  void set_seed(uint64_t seed)
+  {
+    seed_ = seed;
+  }
+
+  /**
+   * @brief Worker threads for large batches; 0 (default) means all hardware threads
+   */
+  void set_num_threads(size_t n)
+  {
+    num_threads_ = n;
+  }
+
+  size_t embedding_dim() const override
+  {
+    return embedding_dim_;
+  }
+  size_t max_token_size() const override
+  {
+    return max_token_size_;
+  }
+  std::string model_name() const override
+  {
+    return "local-ngram" + std::to_string(ngram_min_) + "-" + std::to_string(ngram_max_) + "-seed" +
+           std::to_string(seed_);
+  }
+
+private:
+  static constexpr size_t kProjections = 4;
+  static constexpr size_t kMinParallelBatch = 32;
+  static constexpr float kWordWeight = 1.0f;
+  static constexpr float kNgramWeight = 0.5f;
+
+  static bool is_word_byte(unsigned char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+  }
+
+  // Sparse random projection of one hashed feature: each 32-bit half of a mixed
+  // word picks a component (multiply-shift, no division) and its sign
+  void add_feature(uint64_t h, float weight, float* row) const
+  {
+    for (size_t k = 0; k < kProjections; k += 2)
+    {
+      const uint64_t x = mix64(h + k * 0x9E3779B97F4A7C15ull);
+      const uint32_t halves[2] = { static_cast<uint32_t>(x), static_cast<uint32_t>(x >> 32) };
+      for (uint32_t half : halves)
+      {
+        const size_t d = static_cast<size_t>((static_cast<uint64_t>(half >> 1) * embedding_dim_) >> 31);
+        row[d] += (half & 1) ? weight : -weight;
+      }
+    }
+  }
+
+  void embed_text(std::string_view text, float* row) const
+  {
+    std::string word;  // "<word>", lower-cased
+    size_t i = 0;
+    while (i < text.size())
+    {
+      while (i < text.size() && !is_word_byte(static_cast<unsigned char>(text[i])))
+        ++i;
+      if (i >= text.size())
+        break;
+      word.assign(1, '<');
+      for (; i < text.size() && is_word_byte(static_cast<unsigned char>(text[i])); ++i)
+      {
+        char c = text[i];
+        word.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+      }
+      word.push_back('>');
+      add_feature(fnv1a64(word, seed_), kWordWeight, row);
+      if (ngram_min_ == 0)
+        continue;
+      for (size_t n = ngram_min_; n <= ngram_max_ && n < word.size(); ++n)
+        for (size_t p = 0; p + n <= word.size(); ++p)
+          add_feature(fnv1a64(std::string_view(word).substr(p, n), seed_ + n), kNgramWeight, row);
+    }
+    double norm = 0.0;
+    for (size_t d = 0; d < embedding_dim_; ++d)
+      norm += static_cast<double>(row[d]) * row[d];
+    if (norm > 0.0)
+    {
+      const float inv = static_cast<float>(1.0 / std::sqrt(norm));
+      for (size_t d = 0; d < embedding_dim_; ++d)
+        row[d] *= inv;
+    }
+  }
+
+  size_t embedding_dim_;
+  size_t max_token_size_;
+  size_t ngram_min_{ 3 };
+  size_t ngram_max_{ 5 };
+  uint64_t seed_{ 0x6E67726167ull };
+  size_t num_threads_{ 0 };
+};
+
+}  // namespace nano_graphrag
@@ -1,19 +1,72 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <functional>
 #include <Poco/JSON/Object.h>
 #include <Poco/JSON/Array.h>
-#include <Poco/JSON/Parser.h>
-#include <Poco/Dynamic/Var.h>
 #include "nano_graphrag/interfaces/restapi.hpp"
 #include "nano_graphrag/embedding/base.hpp"
+#include "nano_graphrag/embedding/response_parser.hpp"
+#include "nano_graphrag/operations/tokenize/base.hpp"
+#include "nano_graphrag/utils/ByteScan.hpp"
 #include "nano_graphrag/utils/Log.hpp"
+#include "nano_graphrag/utils/ThreadPool.hpp"
 
 namespace nano_graphrag
 {
 
+/**
+ * @brief How `OpenAIEmbeddingStrategy` handles inputs longer than `max_token_size()`
+ *
+ * @param Truncate Embed only the first `max_token_size()` tokens
+ * @param Split Embed consecutive windows and return their token-weighted, L2-normalized mean
+ */
+enum class LongInputMode
+{
+  Truncate,
+  Split
+};
+
+/**
+ * @brief Wire format requested for embedding vectors (`encoding_format`)
+ *
+ * @param Float JSON number arrays
+ * @param Base64 Base64 of little-endian float32; about a quarter of the payload and no float parsing
+ */
+enum class EmbeddingEncoding
+{
+  Float,
+  Base64
+};
+
+/**
+ * @brief Embeddings from the OpenAI `/v1/embeddings` endpoint
+ *
+ * `embed` packs the inputs into as few requests as the per-request limits allow
+ * (`max_inputs` texts and `max_tokens` tokens, see `set_request_limits`), sends
+ * up to `max_in_flight` of them concurrently and reassembles the vectors in input
+ * order. Inputs longer than `max_token_size()` are truncated or split according
+ * to `LongInputMode`.
+ *
+ * The in-flight bound is shared by all `embed` calls on one instance, since the
+ * requests run on the instance's thread pool.
+ *
+ * Token counts come from the tokenizer set with `set_tokenizer`; without one they
+ * are estimated as one token per two bytes, which over-counts typical text.
+ */
 class OpenAIEmbeddingStrategy : public IEmbeddingStrategy
 {
 public:
@@ -24,8 +77,234 @@ public:
 
   std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const override
   {
+    return embed_matrix(texts).to_vectors();
+  }
+
+  /**
+   * @brief Embed `texts` into `out` (`texts.size() x embedding_dim()`)
+   *
+   * Each response is decoded once and copied into its rows; split inputs are
+   * combined from a scratch matrix of their windows.
+   */
+  void embed_into(const std::vector<std::string>& texts, EmbeddingMatrix& out) const override
+  {
+    out.resize(texts.size(), embedding_dim_);
     if (texts.empty())
-      return {};
+      return;
+    std::vector<Piece> pieces = make_pieces(texts);
+    std::vector<size_t> tokens(pieces.size());
+    for (size_t i = 0; i < pieces.size(); ++i)
+      tokens[i] = pieces[i].tokens;
+    auto requests = pack_requests(tokens, max_inputs_, max_request_tokens_);
+    debug_log("[OpenAIEmbedding] texts=", texts.size(), ", pieces=", pieces.size(),
+              ", requests=", requests.size());
+
+    // Every text is at least one piece, so equal counts mean piece i is text i
+    const bool direct = pieces.size() == texts.size();
+    EmbeddingMatrix scratch;
+    if (!direct)
+      scratch.resize(pieces.size(), embedding_dim_);
+    EmbeddingMatrix& piece_vectors = direct ? out : scratch;
+    auto run = [this, &pieces, &piece_vectors](std::pair<size_t, size_t> range) {
+      std::vector<std::string> inputs;
+      inputs.reserve(range.second - range.first);
+      for (size_t i = range.first; i < range.second; ++i)
+        inputs.emplace_back(pieces[i].text);
+      EmbeddingMatrix vectors = request_embeddings(inputs);
+      if (vectors.rows != inputs.size() || vectors.dim != piece_vectors.dim)
+        throw std::runtime_error("embedding response is " + std::to_string(vectors.rows) + "x" +
+                                 std::to_string(vectors.dim) + ", expected " + std::to_string(inputs.size()) +
+                                 "x" + std::to_string(piece_vectors.dim));
+      std::copy(vectors.values.begin(), vectors.values.end(), piece_vectors.row(range.first));
+    };
+    if (requests.size() == 1 || max_in_flight_ <= 1)
+    {
+      for (const auto& range : requests)
+        run(range);
+    }
+    else
+    {
+      // Every task must finish before returning: they reference this frame
+      auto pool = request_pool();
+      std::vector<std::future<void>> pending;
+      pending.reserve(requests.size());
+      for (const auto& range : requests)
+        pending.push_back(pool->submit([&run, range]() { run(range); }));
+      std::exception_ptr error;
+      for (auto& f : pending)
+      {
+        try
+        {
+          f.get();
+        }
+        catch (...)
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+      if (error)
+        std::rethrow_exception(error);
+    }
+    if (!direct)
+      combine(pieces, scratch, out);
+  }
+
+  /**
+   * @brief Group consecutive inputs into requests within the per-request limits
+   *
+   * Order is preserved, so results can be reassembled by concatenation. An input
+   * that alone exceeds `max_tokens` gets a request of its own.
+   *
+   * @param token_counts Token count of each input
+   * @param max_inputs Max inputs per request
+   * @param max_tokens Max total tokens per request
+   * @return `[begin, end)` index ranges, one per request
+   */
+  static std::vector<std::pair<size_t, size_t>> pack_requests(const std::vector<size_t>& token_counts,
+                                                              size_t max_inputs, size_t max_tokens)
+  {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    max_inputs = std::max<size_t>(max_inputs, 1);
+    size_t begin = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < token_counts.size(); ++i)
+    {
+      if (i > begin && (i - begin >= max_inputs || total + token_counts[i] > max_tokens))
+      {
+        ranges.emplace_back(begin, i);
+        begin = i;
+        total = 0;
+      }
+      total += token_counts[i];
+    }
+    if (begin < token_counts.size())
+      ranges.emplace_back(begin, token_counts.size());
+    return ranges;
+  }
+
+  /**
+   * @brief Tokenizer used to count tokens and to cut over-long inputs
+   *
+   * Should match the embedding model's encoding (cl100k_base for the
+   * text-embedding-3 models); a close encoding is fine for budgeting.
+   */
+  void set_tokenizer(std::shared_ptr<ITokenizerStrategy> tokenizer)
+  {
+    tokenizer_ = std::move(tokenizer);
+  }
+
+  /**
+   * @brief Per-request limits; the API allows 2048 inputs and 300000 tokens per request
+   */
+  void set_request_limits(size_t max_inputs, size_t max_tokens)
+  {
+    max_inputs_ = std::max<size_t>(max_inputs, 1);
+    max_request_tokens_ = std::max<size_t>(max_tokens, 1);
+  }
+
+  void set_long_input_mode(LongInputMode mode)
+  {
+    long_input_mode_ = mode;
+  }
+
+  /**
+   * @brief Response encoding requested from the server (default `Base64`)
+   */
+  void set_encoding(EmbeddingEncoding encoding)
+  {
+    encoding_ = encoding;
+  }
+
+  /**
+   * @brief Max requests sent concurrently (default 16); 1 sends them one after another
+   */
+  void set_max_in_flight(size_t n)
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    max_in_flight_ = std::max<size_t>(n, 1);
+    pool_.reset();
+  }
+
+  /**
+   * @brief Connect, send and receive timeout of each request (default 60 s)
+   */
+  void set_request_timeout(std::chrono::milliseconds timeout)
+  {
+    request_timeout_ = timeout;
+  }
+
+  /**
+   * @brief Embeddings endpoint URL (default `https://api.openai.com/v1/embeddings`)
+   *
+   * Any server speaking the same JSON protocol works, e.g. a local proxy or a
+   * stand-in server for tests.
+   */
+  void set_endpoint(const std::string& url)
+  {
+    endpoint_ = url;
+  }
+
+  /**
+   * @brief API key sent as a bearer token; defaults to `OPENAI_API_KEY`
+   *
+   * The key is required for the default endpoint only; other endpoints are
+   * called without authorization when no key is available.
+   */
+  void set_api_key(const std::string& key)
+  {
+    api_key_ = key;
+  }
+
+  /**
+   * @brief Model sent with each request (default `text-embedding-3-small`)
+   *
+   * @param model Model name, e.g. `text-embedding-3-large`
+   * @param dim The model's output dimension, or 0 to keep the current one; a
+   *            dimension requested with `set_dimensions` takes precedence
+   */
+  void set_model(const std::string& model, size_t dim = 0)
+  {
+    model_ = model;
+    if (dim > 0 && dimensions_ == 0)
+      embedding_dim_ = dim;
+  }
+
+  /**
+   * @brief Ask the server for `dim`-dimensional vectors via the `dimensions` parameter
+   *
+   * Supported by the text-embedding-3 models, which shorten their Matryoshka
+   * embeddings server-side (the prefix, L2-normalized); `embedding_dim()` becomes
+   * `dim`. 0 stops sending the parameter. To keep full-size vectors in a cache
+   * and serve a shorter index from them, wrap the strategy in a
+   * `TruncatedEmbeddingStrategy` instead.
+   */
+  void set_dimensions(size_t dim)
+  {
+    if (dim > 0)
+      embedding_dim_ = dim;
+    dimensions_ = dim;
+  }
+
+  size_t embedding_dim() const override
+  {
+    return embedding_dim_;
+  }
+  size_t max_token_size() const override
+  {
+    return max_token_size_;
+  }
+  std::string model_name() const override
+  {
+    return model_;
+  }
+
+protected:
+  /**
+   * @brief Send one `/v1/embeddings` request and return the vectors in input order
+   */
+  virtual EmbeddingMatrix request_embeddings(const std::vector<std::string>& texts) const
+  {
     debug_log("[OpenAIEmbedding] batch=", texts.size());
     using namespace Poco::JSON;
     Object::Ptr body = new Object();
@@ -33,66 +312,175 @@ public:
     for (const auto& t : texts)
       arr->add(t);
     body->set("input", arr);
-    body->set("model", "text-embedding-3-small"); // configurable if needed
+    body->set("model", model_);
+    if (dimensions_ > 0)
+      body->set("dimensions", static_cast<int>(dimensions_));
+    body->set("encoding_format", encoding_ == EmbeddingEncoding::Base64 ? "base64" : "float");
 
     nano_graphrag::RestClient client;
-    client.set_uri("https://api.openai.com/v1/embeddings");
+    client.set_uri(endpoint_);
     client.set_method("POST");
     client.set_ssl_verify(true); // SSL verification ON for production
-    const char* key = std::getenv("OPENAI_API_KEY");
-    if (!key)
+    const long timeout_ms = static_cast<long>(request_timeout_.count());
+    client.set_timeout(Poco::Timespan(timeout_ms / 1000, (timeout_ms % 1000) * 1000));
+    std::string key = api_key_;
+    if (key.empty() && std::getenv("OPENAI_API_KEY"))
+      key = std::getenv("OPENAI_API_KEY");
+    if (key.empty() && endpoint_ == kDefaultEndpoint)
       throw std::runtime_error("OPENAI_API_KEY not set");
-    client.set_auth_bearer(key);
+    if (!key.empty())
+      client.set_auth_bearer(key);
+
+    std::ostringstream request_body;
+    body->stringify(request_body);
+    // The response is scanned directly instead of being built into a DOM; vectors
+    // are placed by their `index`, so they come back in input order.
+    const std::string response = client.post(request_body.str(), endpoint_);
+    EmbeddingMatrix parsed = parse_embedding_response(response, texts.size(), embedding_dim_);
+    debug_log("[OpenAIEmbedding] response rows=", parsed.rows, ", dim=", parsed.dim);
+    return parsed;
+  }
+
+private:
+  /**
+   * @brief Text sent as one API input: a whole input text or one window of a long one
+   */
+  struct Piece
+  {
+    std::string_view text;
+    size_t source;
+    size_t tokens;
+  };
+
+  static constexpr const char* kDefaultEndpoint = "https://api.openai.com/v1/embeddings";
+
+  std::shared_ptr<ThreadPool> request_pool() const
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!pool_)
+      pool_ = std::make_shared<ThreadPool>(max_in_flight_);
+    return pool_;
+  }
 
-    Object::Ptr response = client.post_json(*body, "https://api.openai.com/v1/embeddings");
-    std::vector<std::vector<float>> result;
-    if (response->has("data"))
+  size_t count_tokens(std::string_view text) const
+  {
+    if (tokenizer_)
+      return tokenizer_->count_tokens(text);
+    return (text.size() + 1) / 2;
+  }
+
+  std::vector<Piece> make_pieces(const std::vector<std::string>& texts) const
+  {
+    std::vector<Piece> pieces;
+    pieces.reserve(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i)
     {
-      Array::Ptr data = response->getArray("data");
-      debug_log("[OpenAIEmbedding] response items=", data->size());
-      // The API returns an array of objects with 'embedding' and 'index'.
-      // We must return embeddings in the same order as input texts.
-      // We'll use a temporary map to sort by 'index'.
-      std::map<size_t, std::vector<float>> ordered;
-      for (size_t i = 0; i < data->size(); ++i)
+      size_t tokens = count_tokens(texts[i]);
+      if (tokens <= max_token_size_)
       {
-        Object::Ptr item = data->getObject(i);
-        if (item->has("embedding") && item->has("index"))
-        {
-          size_t idx = static_cast<size_t>(item->getValue<int>("index"));
-          Array::Ptr emb = item->getArray("embedding");
-          std::vector<float> vec;
-          vec.reserve(emb->size());
-          for (size_t j = 0; j < emb->size(); ++j)
-          {
-            vec.push_back(static_cast<float>(emb->get(j).convert<double>()));
-          }
-          ordered[idx] = std::move(vec);
-        }
+        pieces.push_back(Piece{ texts[i], i, std::max<size_t>(tokens, 1) });
+        continue;
       }
-      // Reconstruct result in input order
-      result.resize(texts.size());
-      for (const auto& kv : ordered)
+      for (const auto& window : split_input(texts[i]))
       {
-        if (kv.first < result.size())
-          result[kv.first] = kv.second;
+        pieces.push_back(Piece{ window.first, i, window.second });
+        if (long_input_mode_ == LongInputMode::Truncate)
+          break;
       }
     }
-    return result;
+    return pieces;
   }
 
-  size_t embedding_dim() const override
+  /**
+   * @brief Cut `text` into consecutive windows of at most `max_token_size_` tokens
+   *
+   * Uses token offsets when the tokenizer has them, otherwise byte windows sized
+   * by the two-bytes-per-token estimate. Cuts never split a UTF-8 character.
+   */
+  std::vector<std::pair<std::string_view, size_t>> split_input(const std::string& text) const
   {
-    return embedding_dim_;
+    std::vector<std::pair<std::string_view, size_t>> windows;
+    const size_t limit = std::max<size_t>(max_token_size_, 1);
+    if (tokenizer_ && tokenizer_->supports_offsets())
+    {
+      auto offsets = tokenizer_->encode_offsets(text);
+      size_t begin = 0;
+      for (size_t start = 0; start < offsets.size(); start += limit)
+      {
+        size_t last = std::min(start + limit, offsets.size()) - 1;
+        size_t end = last + 1 < offsets.size() ? utf8_boundary(text, offsets[last + 1].begin) : text.size();
+        end = std::max(begin, end);
+        windows.emplace_back(std::string_view(text).substr(begin, end - begin), last - start + 1);
+        begin = end;
+      }
+      return windows;
+    }
+    const size_t window_bytes = limit * 2;
+    for (size_t begin = 0; begin < text.size();)
+    {
+      size_t end = std::max(begin + 1, utf8_boundary(text, begin + window_bytes));
+      end = std::min(end, text.size());
+      std::string_view window = std::string_view(text).substr(begin, end - begin);
+      windows.emplace_back(window, count_tokens(window));
+      begin = end;
+    }
+    return windows;
   }
-  size_t max_token_size() const override
+
+  /**
+   * @brief One row per input: single pieces as-is, split inputs as their normalized weighted mean
+   */
+  static void combine(const std::vector<Piece>& pieces, const EmbeddingMatrix& vectors, EmbeddingMatrix& out)
   {
-    return max_token_size_;
+    const size_t dim = out.dim;
+    for (size_t i = 0; i < pieces.size();)
+    {
+      size_t j = i + 1;
+      while (j < pieces.size() && pieces[j].source == pieces[i].source)
+        ++j;
+      float* mean = out.row(pieces[i].source);
+      if (j == i + 1)
+      {
+        std::copy_n(vectors.row(i), dim, mean);
+        i = j;
+        continue;
+      }
+      std::fill_n(mean, dim, 0.0f);
+      for (size_t k = i; k < j; ++k)
+      {
+        const float w = static_cast<float>(pieces[k].tokens);
+        const float* v = vectors.row(k);
+        for (size_t d = 0; d < dim; ++d)
+          mean[d] += w * v[d];
+      }
+      double norm = 0.0;
+      for (size_t d = 0; d < dim; ++d)
+        norm += static_cast<double>(mean[d]) * mean[d];
+      if (norm > 0.0)
+      {
+        const float inv = static_cast<float>(1.0 / std::sqrt(norm));
+        for (size_t d = 0; d < dim; ++d)
+          mean[d] *= inv;
+      }
+      i = j;
+    }
   }
 
-private:
   size_t embedding_dim_;
   size_t max_token_size_;
+  size_t max_inputs_{ 2048 };
+  size_t max_request_tokens_{ 300000 };
+  LongInputMode long_input_mode_{ LongInputMode::Split };
+  std::shared_ptr<ITokenizerStrategy> tokenizer_;
+  size_t max_in_flight_{ 16 };
+  std::chrono::milliseconds request_timeout_{ 60000 };
+  std::string endpoint_{ kDefaultEndpoint };
+  std::string api_key_;
+  std::string model_{ "text-embedding-3-small" };
+  size_t dimensions_{ 0 };  // `dimensions` request parameter; 0 = model default
+  EmbeddingEncoding encoding_{ EmbeddingEncoding::Base64 };
+  mutable std::mutex pool_mutex_;
+  mutable std::shared_ptr<ThreadPool> pool_;
 };
 
 }  // namespace nano_graphrag
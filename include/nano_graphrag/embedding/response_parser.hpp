@@ -0,0 +1,325 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nano_graphrag/embedding/base.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Decode base64 text straight into little-endian float32 values
+ *
+ * @param b64 Base64 text (standard alphabet, optional `=` padding)
+ * @param out Destination for `max_values` floats
+ * @param max_values Capacity of `out`
+ * @return Number of floats written; throws on invalid input or overflow
+ */
+inline size_t decode_base64_floats(std::string_view b64, float* out, size_t max_values)
+{
+  static const auto kTable = []() {
+    struct Table
+    {
+      int8_t v[256];
+    } t{};
+    std::memset(t.v, -1, sizeof(t.v));
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (int i = 0; i < 64; ++i)
+      t.v[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+    return t;
+  }();
+  while (!b64.empty() && b64.back() == '=')
+    b64.remove_suffix(1);
+  const size_t bytes = b64.size() * 3 / 4;
+  if (bytes % sizeof(float) != 0 || bytes / sizeof(float) > max_values || b64.size() % 4 == 1)
+    throw std::runtime_error("base64 embedding has an invalid length");
+
+  auto* dst = reinterpret_cast<unsigned char*>(out);
+  const auto* src = reinterpret_cast<const unsigned char*>(b64.data());
+  size_t i = 0;
+  size_t o = 0;
+  int bad = 0;
+  for (; i + 4 <= b64.size(); i += 4, o += 3)
+  {
+    const int a = kTable.v[src[i]], b = kTable.v[src[i + 1]];
+    const int c = kTable.v[src[i + 2]], d = kTable.v[src[i + 3]];
+    bad |= a | b | c | d;
+    const uint32_t n = (static_cast<uint32_t>(a) << 18) | (static_cast<uint32_t>(b) << 12) |
+                       (static_cast<uint32_t>(c) << 6) | static_cast<uint32_t>(d);
+    dst[o] = static_cast<unsigned char>(n >> 16);
+    dst[o + 1] = static_cast<unsigned char>(n >> 8);
+    dst[o + 2] = static_cast<unsigned char>(n);
+  }
+  if (i < b64.size())
+  {
+    uint32_t n = 0;
+    const size_t rest = b64.size() - i;
+    for (size_t k = 0; k < 4; ++k)
+    {
+      const int v = k < rest ? kTable.v[src[i + k]] : 0;
+      bad |= v;
+      n = (n << 6) | static_cast<uint32_t>(v & 0x3F);
+    }
+    for (size_t k = 0; k + 1 < rest; ++k)
+      dst[o++] = static_cast<unsigned char>(n >> (16 - 8 * k));
+  }
+  if (bad < 0)
+    throw std::runtime_error("base64 embedding contains invalid characters");
+  return bytes / sizeof(float);
+}
+
+/**
+ * @brief Parse an embeddings response body without building a DOM
+ *
+ * Walks the JSON once, skipping everything but `data[*].index` and
+ * `data[*].embedding`. Embeddings may be JSON number arrays or base64 strings
+ * (`encoding_format: "base64"`); both are written straight into the rows of one
+ * `EmbeddingMatrix`, which is allocated once. Row `i` holds the vector whose
+ * `index` is `i`; rows missing from the response are left as zeros.
+ *
+ * @param body Response body
+ * @param rows Expected number of vectors (the request's input count)
+ * @param dim_hint Expected dimension, or 0 to take it from the first vector
+ * @return The decoded matrix; throws `std::runtime_error` on malformed input
+ */
+inline EmbeddingMatrix parse_embedding_response(std::string_view body, size_t rows, size_t dim_hint = 0)
+{
+  struct Scanner
+  {
+    std::string_view s;
+    size_t p{ 0 };
+
+    [[noreturn]] void fail(const char* what) const
+    {
+      throw std::runtime_error(std::string("embedding response: ") + what + " at offset " +
+                               std::to_string(p));
+    }
+    void ws()
+    {
+      while (p < s.size() && (s[p] == ' ' || s[p] == '\n' || s[p] == '\r' || s[p] == '\t'))
+        ++p;
+    }
+    char peek()
+    {
+      ws();
+      return p < s.size() ? s[p] : '\0';
+    }
+    void expect(char c)
+    {
+      if (peek() != c)
+        fail("unexpected character");
+      ++p;
+    }
+    // Raw (still escaped) string contents between the quotes
+    std::string_view string()
+    {
+      expect('"');
+      const size_t begin = p;
+      for (;;)
+      {
+        // memchr to the next quote; it closes the string unless preceded by an odd number of backslashes
+        const void* q = std::memchr(s.data() + p, '"', s.size() - p);
+        if (!q)
+          fail("unterminated string");
+        p = static_cast<size_t>(static_cast<const char*>(q) - s.data());
+        size_t slashes = 0;
+        while (p - slashes > begin && s[p - slashes - 1] == '\\')
+          ++slashes;
+        if (slashes % 2 == 0)
+          break;
+        ++p;
+      }
+      return s.substr(begin, p++ - begin);
+    }
+    void skip_value()
+    {
+      const char c = peek();
+      if (c == '"')
+      {
+        string();
+        return;
+      }
+      if (c == '{' || c == '[')
+      {
+        int depth = 0;
+        do
+        {
+          const char d = s[p];
+          if (d == '"')
+          {
+            string();
+            continue;
+          }
+          depth += (d == '{' || d == '[') - (d == '}' || d == ']');
+          ++p;
+        } while (depth > 0 && p < s.size());
+        if (depth > 0)
+          fail("unterminated container");
+        return;
+      }
+      while (p < s.size() && s[p] != ',' && s[p] != '}' && s[p] != ']')
+        ++p;
+    }
+    size_t integer()
+    {
+      ws();
+      size_t v = 0;
+      const size_t begin = p;
+      while (p < s.size() && s[p] >= '0' && s[p] <= '9')
+        v = v * 10 + static_cast<size_t>(s[p++] - '0');
+      if (p == begin)
+        fail("invalid index");
+      return v;
+    }
+    float number()
+    {
+      ws();
+      const char* begin = s.data() + p;
+      const char* end = s.data() + s.size();
+      float v = 0.0f;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+      auto r = std::from_chars(begin, end, v);
+      if (r.ec != std::errc())
+        fail("invalid number");
+      p += static_cast<size_t>(r.ptr - begin);
+#else
+      char* stop = nullptr;
+      v = std::strtof(begin, &stop);
+      if (stop == begin)
+        fail("invalid number");
+      p += static_cast<size_t>(stop - begin);
+#endif
+      return v;
+    }
+  };
+
+  EmbeddingMatrix out(rows, dim_hint);
+
+  // Decode one `embedding` value (its raw text `raw`) into row `index`
+  auto store = [&out, rows](Scanner& sc, std::string_view raw, size_t index) {
+    if (index >= rows)
+      sc.fail("index out of range");
+    if (!raw.empty() && raw.front() == '"')
+    {
+      std::string_view b64 = raw.substr(1, raw.size() - 2);
+      std::string unescaped;
+      if (b64.find('\\') != std::string_view::npos)
+      {
+        for (size_t i = 0; i < b64.size(); ++i)
+          if (b64[i] != '\\')
+            unescaped.push_back(b64[i]);
+        b64 = unescaped;
+      }
+      size_t trimmed = b64.size();
+      while (trimmed > 0 && b64[trimmed - 1] == '=')
+        --trimmed;
+      const size_t count = trimmed * 3 / 4 / sizeof(float);
+      if (!out.dim)
+      {
+        out.resize(rows, count);
+      }
+      if (count != out.dim)
+        sc.fail("embedding dimension mismatch");
+      decode_base64_floats(b64, out.row(index), out.dim);
+      return;
+    }
+    Scanner inner{ raw, 0 };
+    inner.expect('[');
+    if (!out.dim)
+    {
+      // first vector: count the elements once to size the matrix
+      size_t count = 0;
+      Scanner counter{ raw, 1 };
+      if (counter.peek() != ']')
+      {
+        for (;;)
+        {
+          counter.number();
+          ++count;
+          if (counter.peek() != ',')
+            break;
+          ++counter.p;
+        }
+      }
+      out.resize(rows, count);
+    }
+    float* row = out.row(index);
+    size_t n = 0;
+    if (inner.peek() != ']')
+    {
+      for (;;)
+      {
+        if (n == out.dim)
+          sc.fail("embedding dimension mismatch");
+        row[n++] = inner.number();
+        if (inner.peek() != ',')
+          break;
+        ++inner.p;
+      }
+    }
+    inner.expect(']');
+    if (n != out.dim)
+      sc.fail("embedding dimension mismatch");
+  };
+
+  Scanner sc{ body, 0 };
+  bool found_data = false;
+  sc.expect('{');
+  while (sc.peek() != '}')
+  {
+    std::string_view key = sc.string();
+    sc.expect(':');
+    if (key != "data")
+    {
+      sc.skip_value();
+    }
+    else
+    {
+      found_data = true;
+      sc.expect('[');
+      size_t position = 0;
+      while (sc.peek() != ']')
+      {
+        sc.expect('{');
+        size_t index = position;
+        std::string_view embedding;
+        while (sc.peek() != '}')
+        {
+          std::string_view field = sc.string();
+          sc.expect(':');
+          const size_t begin = (sc.ws(), sc.p);
+          if (field == "index")
+            index = sc.integer();
+          else
+            sc.skip_value();
+          if (field == "embedding")
+            embedding = body.substr(begin, sc.p - begin);
+          if (sc.peek() == ',')
+            ++sc.p;
+        }
+        ++sc.p;
+        if (embedding.empty())
+          sc.fail("item without embedding");
+        store(sc, embedding, index);
+        ++position;
+        if (sc.peek() == ',')
+          ++sc.p;
+      }
+      ++sc.p;
+    }
+    if (sc.peek() == ',')
+      ++sc.p;
+  }
+  if (!found_data)
+    sc.fail("no data array");
+  return out;
+}
+
+}  // namespace nano_graphrag
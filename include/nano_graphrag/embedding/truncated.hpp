@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nano_graphrag/embedding/base.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Decorator that serves another strategy's embeddings at a lower dimension
+ *
+ * Keeps the first `dim` components of each vector and rescales them to unit
+ * length. For Matryoshka-trained models (OpenAI text-embedding-3, nomic, ...)
+ * the prefix is itself a usable embedding, so an index can run at 256 or 512
+ * dimensions from vectors produced (or cached) at full size. This is the same
+ * reduction the OpenAI API applies for the `dimensions` request parameter.
+ *
+ * Vector storages size their index from `embedding_dim()`, so they pick up the
+ * reduced dimension directly.
+ */
+class TruncatedEmbeddingStrategy : public IEmbeddingStrategy
+{
+public:
+  /**
+   * @brief Serve `inner`'s embeddings cut to `dim` components
+   *
+   * @param inner Strategy producing the full-size vectors
+   * @param dim Target dimension; at most `inner->embedding_dim()` when that is known
+   */
+  TruncatedEmbeddingStrategy(std::shared_ptr<IEmbeddingStrategy> inner, size_t dim)
+    : inner_(std::move(inner)), dim_(dim)
+  {
+    if (!inner_)
+      throw std::invalid_argument("TruncatedEmbeddingStrategy requires an inner strategy");
+    if (dim_ == 0 || (inner_->embedding_dim() > 0 && dim_ > inner_->embedding_dim()))
+      throw std::invalid_argument("truncated dimension " + std::to_string(dim_) + " is not in [1, " +
+                                  std::to_string(inner_->embedding_dim()) + "]");
+  }
+
+  std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const override
+  {
+    return embed_matrix(texts).to_vectors();
+  }
+
+  void embed_into(const std::vector<std::string>& texts, EmbeddingMatrix& out) const override
+  {
+    EmbeddingMatrix full;
+    inner_->embed_into(texts, full);
+    out.resize(full.rows, dim_);
+    const size_t width = std::min(dim_, full.dim);
+    for (size_t i = 0; i < full.rows; ++i)
+    {
+      const float* src = full.row(i);
+      float* dst = out.row(i);
+      double norm = 0.0;
+      for (size_t d = 0; d < width; ++d)
+      {
+        dst[d] = src[d];
+        norm += static_cast<double>(src[d]) * src[d];
+      }
+      if (norm > 0.0)
+      {
+        const float inv = static_cast<float>(1.0 / std::sqrt(norm));
+        for (size_t d = 0; d < width; ++d)
+          dst[d] *= inv;
+      }
+    }
+  }
+
+  size_t embedding_dim() const override
+  {
+    return dim_;
+  }
+  size_t max_token_size() const override
+  {
+    return inner_->max_token_size();
+  }
+  std::string model_name() const override
+  {
+    return inner_->model_name();
+  }
+
+  const std::shared_ptr<IEmbeddingStrategy>& inner() const
+  {
+    return inner_;
+  }
+
+private:
+  std::shared_ptr<IEmbeddingStrategy> inner_;
+  size_t dim_;
+};
+
+}  // namespace nano_graphrag
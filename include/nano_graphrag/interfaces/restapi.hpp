@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <sstream>
+#include <iterator>
 
 #include <Poco/JSON/Object.h>
 #include <Poco/JSON/Parser.h>
@@ -14,7 +15,9 @@
 #include <Poco/Net/HTTPClientSession.h>
 #include <Poco/Net/NetException.h>
 #include <Poco/URI.h>
+#include <Poco/Exception.h>
 #include <Poco/Timespan.h>
+#include "nano_graphrag/interfaces/session_pool.hpp"
 #include "nano_graphrag/utils/Log.hpp"
 
 namespace nano_graphrag
@@ -47,21 +50,49 @@ public:
   {
     auth_type_ = t;
   }
+  /**
+   * @brief Connect, send and receive timeout for each request (default 60 s)
+   */
+  void set_timeout(const Poco::Timespan& timeout)
+  {
+    timeout_ = timeout;
+  }
+  /**
+   * @brief Keep-alive sessions to reuse (default `HTTPSessionPool::shared()`)
+   *
+   * nullptr opens and closes a session, and for HTTPS an SSL context, per request.
+   */
+  void set_session_pool(std::shared_ptr<HTTPSessionPool> pool)
+  {
+    session_pool_ = std::move(pool);
+  }
 
   Poco::JSON::Object::Ptr post_json(Poco::JSON::Object& body_json, const std::string& uri)
+  {
+    std::ostringstream body_stream;
+    body_json.stringify(body_stream);
+    std::string response_body = post(body_stream.str(), uri);
+    Poco::JSON::Parser parser;
+    Poco::Dynamic::Var result = parser.parse(response_body);
+    return result.extract<Poco::JSON::Object::Ptr>();
+  }
+
+  /**
+   * @brief POST a JSON body and return the raw response body
+   *
+   * For callers that parse the response themselves, e.g. large embedding batches.
+   */
+  std::string post(const std::string& body, const std::string& uri)
   {
     Poco::URI uri_obj(uri);
 
     debug_log("[RestClient] POST ", uri);
 
-    std::ostringstream body_stream;
-    body_json.stringify(body_stream);
-
     Poco::Net::HTTPRequest request(method_, uri_obj.getPathEtc());
     request.setVersion(Poco::Net::HTTPMessage::HTTP_1_1);
     request.setHost(uri_obj.getHost());
     request.setContentType("application/json");
-    request.setContentLength(body_stream.str().size());
+    request.setContentLength(static_cast<std::streamsize>(body.size()));
     request.set("Accept", "application/json");
 
     if (auth_type_ == "Bearer" && !api_key_.empty())
@@ -69,28 +100,52 @@ public:
       request.setCredentials(auth_type_, api_key_);
     }
 
-    std::unique_ptr<Poco::Net::HTTPClientSession> session_ptr;
-    if (uri_obj.getScheme() == "https")
+    if (!session_pool_)
     {
-      Poco::Net::Context::Params params;
-      params.verificationMode =
-          ssl_verify_ ? Poco::Net::Context::VERIFY_STRICT : Poco::Net::Context::VERIFY_NONE;
-      if (ssl_verify_)
-        params.caLocation = "/etc/ssl/certs";
-      Poco::Net::Context::Ptr context = new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, params);
-      session_ptr =
-          std::make_unique<Poco::Net::HTTPSClientSession>(uri_obj.getHost(), uri_obj.getPort(), context);
+      auto session = HTTPSessionPool::open(uri_obj, ssl_verify_);
+      Poco::Net::HTTPResponse response;
+      std::istream& rs = exchange(*session, request, body, response);
+      return read_body(response, rs);
     }
-    else
+
+    // An idle pooled session may have been closed by the server; such a request
+    // fails before any response arrives and is sent again on another session.
+    // Timeouts are not retried: the server may be processing the request.
+    for (;;)
     {
-      session_ptr = std::make_unique<Poco::Net::HTTPClientSession>(uri_obj.getHost(), uri_obj.getPort());
+      HTTPSessionPool::Lease session = session_pool_->acquire(uri_obj, ssl_verify_);
+      Poco::Net::HTTPResponse response;
+      std::istream* rs = nullptr;
+      try
+      {
+        rs = &exchange(*session, request, body, response);
+      }
+      catch (const Poco::IOException& e)
+      {
+        if (!session.reused())
+          throw;
+        debug_log("[RestClient] stale pooled connection, reconnecting: ", e.displayText());
+        continue;
+      }
+      std::string response_body = read_body(response, *rs);
+      // reusable only if the body was delimited by its length and read in full
+      const std::streamsize length = response.getContentLength();
+      if (response.getKeepAlive() && length >= 0 && response_body.size() == static_cast<size_t>(length))
+        session.release();
+      return response_body;
     }
+  }
 
+private:
+  // Send the request and receive the response headers
+  std::istream& exchange(Poco::Net::HTTPClientSession& session, Poco::Net::HTTPRequest& request,
+                         const std::string& body, Poco::Net::HTTPResponse& response)
+  {
     try
     {
-      session_ptr->setTimeout(Poco::Timespan(60, 0));
-      std::ostream& os = session_ptr->sendRequest(request);
-      body_json.stringify(os);
+      session.setTimeout(timeout_);
+      std::ostream& os = session.sendRequest(request);
+      os.write(body.data(), static_cast<std::streamsize>(body.size()));
       debug_log("[RestClient] request sent, awaiting response...");
     }
     catch (const Poco::Net::NetException& e)
@@ -99,12 +154,15 @@ public:
       throw;
     }
 
-    Poco::Net::HTTPResponse response;
-    std::istream& rs = session_ptr->receiveResponse(response);
+    std::istream& rs = session.receiveResponse(response);
 
     debug_log("[RestClient] response status=", static_cast<int>(response.getStatus()), " ",
               response.getReason());
+    return rs;
+  }
 
+  static std::string read_body(const Poco::Net::HTTPResponse& response, std::istream& rs)
+  {
     if (response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK)
     {
       throw Poco::Net::NetException("HTTP Error: " + std::to_string(response.getStatus()) + " " +
@@ -124,17 +182,28 @@ public:
       throw Poco::Net::NetException("HTTP Chunked Transfer Encoding not supported");
     }
 
-    Poco::JSON::Parser parser;
-    Poco::Dynamic::Var result = parser.parse(rs);
-    return result.extract<Poco::JSON::Object::Ptr>();
+    std::string response_body;
+    const std::streamsize length = response.getContentLength();
+    if (length > 0)
+    {
+      response_body.resize(static_cast<size_t>(length));
+      rs.read(&response_body[0], length);
+      response_body.resize(static_cast<size_t>(rs.gcount()));
+    }
+    else
+    {
+      response_body.assign(std::istreambuf_iterator<char>(rs), std::istreambuf_iterator<char>());
+    }
+    return response_body;
   }
 
-private:
   std::string uri_;
   std::string method_{ "POST" };
   bool ssl_verify_{ true };
   std::string auth_type_{ "Bearer" };
   std::string api_key_;
+  Poco::Timespan timeout_{ 60, 0 };
+  std::shared_ptr<HTTPSessionPool> session_pool_{ HTTPSessionPool::shared() };
 };
 
 }  // namespace nano_graphrag
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Poco/Net/Context.h>
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPSClientSession.h>
+#include <Poco/Timespan.h>
+#include <Poco/URI.h>
+#include "nano_graphrag/utils/Log.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Thread-safe pool of keep-alive HTTP(S) client sessions, keyed by scheme, host and port
+ *
+ * `acquire` hands out an idle session for the host when there is one and opens
+ * a new one otherwise; a `Lease` puts it back once the caller has read the whole
+ * response. Up to `max_idle_per_host` sessions are kept per host (extra ones are
+ * closed on return) and sessions idle for longer than `idle_timeout` are dropped.
+ * HTTPS sessions share one SSL context per verification mode, so neither the CA
+ * store nor the TCP and TLS handshakes are redone per request.
+ *
+ * The pool never blocks: concurrency is bounded by the callers (e.g.
+ * `set_max_in_flight` on the strategies), and every concurrent request gets its
+ * own session. A pooled socket can still have been closed by the server;
+ * `Lease::reused()` lets the caller retry such a request once on a fresh session.
+ */
+class HTTPSessionPool
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Exclusive use of one session; returned to the pool by `release()`, closed otherwise
+   */
+  class Lease
+  {
+  public:
+    Lease() = default;
+    Lease(Lease&& o) noexcept
+      : pool_(o.pool_), key_(std::move(o.key_)), session_(std::move(o.session_)), reused_(o.reused_)
+    {
+      o.pool_ = nullptr;
+    }
+    /** Closes the session held so far (as the destructor would), then takes over `o`'s. */
+    Lease& operator=(Lease&& o) noexcept
+    {
+      if (this != &o)
+      {
+        close();
+        pool_ = o.pool_;
+        key_ = std::move(o.key_);
+        session_ = std::move(o.session_);
+        reused_ = o.reused_;
+        o.pool_ = nullptr;
+      }
+      return *this;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    ~Lease()
+    {
+      close();
+    }
+
+    Poco::Net::HTTPClientSession& operator*() const
+    {
+      return *session_;
+    }
+    Poco::Net::HTTPClientSession* operator->() const
+    {
+      return session_.get();
+    }
+
+    /** True if the session served an earlier request, i.e. its socket may be stale. */
+    bool reused() const
+    {
+      return reused_;
+    }
+
+    /**
+     * @brief Hand the session back for reuse; only call once the response body has been read in full
+     */
+    void release()
+    {
+      if (pool_ && session_)
+        pool_->put_back(key_, std::move(session_));
+      session_.reset();
+    }
+
+  private:
+    friend class HTTPSessionPool;
+    void close()
+    {
+      if (pool_ && session_)
+        pool_->closed_one();
+      session_.reset();
+    }
+
+    Lease(HTTPSessionPool* pool, std::string key, std::unique_ptr<Poco::Net::HTTPClientSession> session,
+          bool reused)
+      : pool_(pool), key_(std::move(key)), session_(std::move(session)), reused_(reused)
+    {
+    }
+
+    HTTPSessionPool* pool_{ nullptr };
+    std::string key_;
+    std::unique_ptr<Poco::Net::HTTPClientSession> session_;
+    bool reused_{ false };
+  };
+
+  /**
+   * @param max_idle_per_host Idle sessions kept per host; 0 disables reuse
+   * @param idle_timeout Idle sessions older than this are closed instead of reused
+   */
+  explicit HTTPSessionPool(size_t max_idle_per_host = 16,
+                           std::chrono::milliseconds idle_timeout = std::chrono::seconds{ 30 })
+    : max_idle_per_host_(max_idle_per_host), idle_timeout_(idle_timeout)
+  {
+  }
+
+  HTTPSessionPool(const HTTPSessionPool&) = delete;
+  HTTPSessionPool& operator=(const HTTPSessionPool&) = delete;
+
+  /**
+   * @brief Process-wide pool used by every `RestClient` unless told otherwise
+   */
+  static const std::shared_ptr<HTTPSessionPool>& shared()
+  {
+    static const std::shared_ptr<HTTPSessionPool> pool = std::make_shared<HTTPSessionPool>();
+    return pool;
+  }
+
+  /**
+   * @brief Open a standalone session with its own SSL context (the unpooled path)
+   */
+  static std::unique_ptr<Poco::Net::HTTPClientSession> open(const Poco::URI& uri, bool ssl_verify)
+  {
+    return open(uri, make_context(uri, ssl_verify));
+  }
+
+  /**
+   * @brief Take an idle session for `uri`'s scheme, host and port, or open a new one
+   *
+   * The lease must not outlive the pool.
+   */
+  Lease acquire(const Poco::URI& uri, bool ssl_verify)
+  {
+    std::string key = uri.getScheme() + "://" + uri.getHost() + ":" + std::to_string(uri.getPort()) +
+                      (ssl_verify ? "" : "#insecure");
+    Poco::Net::Context::Ptr context;
+    long idle_ms = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = idle_.find(key);
+      if (it != idle_.end())
+      {
+        evict_expired(it->second, Clock::now());
+        // most recently returned first: least likely to have been closed by the server
+        while (!it->second.empty())
+        {
+          auto session = std::move(it->second.back().session);
+          it->second.pop_back();
+          if (!session->connected())
+          {
+            ++evicted_;
+            continue;
+          }
+          ++reused_;
+          ++leased_;
+          return Lease(this, std::move(key), std::move(session), true);
+        }
+      }
+      ++created_;
+      ++leased_;
+      idle_ms = static_cast<long>(idle_timeout_.count());
+      if (uri.getScheme() == "https")
+      {
+        Poco::Net::Context::Ptr& shared = ssl_verify ? verify_context_ : insecure_context_;
+        if (!shared)
+          shared = make_context(uri, ssl_verify);
+        context = shared;
+      }
+    }
+    debug_log("[HTTPSessionPool] new session ", key);
+    auto session = open(uri, context);
+    session->setKeepAlive(true);
+    session->setKeepAliveTimeout(Poco::Timespan(idle_ms / 1000, (idle_ms % 1000) * 1000));
+    return Lease(this, std::move(key), std::move(session), false);
+  }
+
+  /**
+   * @brief Close every idle session older than the idle timeout
+   */
+  void evict_idle()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    for (auto& kv : idle_)
+      evict_expired(kv.second, now);
+  }
+
+  /**
+   * @brief Close every idle session; leased sessions are not affected
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& kv : idle_)
+      evicted_ += kv.second.size();
+    idle_.clear();
+  }
+
+  void set_max_idle_per_host(size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_idle_per_host_ = n;
+  }
+  void set_idle_timeout(std::chrono::milliseconds timeout)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_timeout_ = timeout;
+  }
+
+  /** Sessions opened since construction. */
+  size_t created() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+  }
+  /** Leases served by an idle session. */
+  size_t reused() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reused_;
+  }
+  /** Idle sessions closed for age, a dropped connection or `clear()`. */
+  size_t evicted() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evicted_;
+  }
+  /** Sessions currently idle in the pool, over all hosts. */
+  size_t idle() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (const auto& kv : idle_)
+      n += kv.second.size();
+    return n;
+  }
+  /** Sessions currently leased out. */
+  size_t leased() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return leased_;
+  }
+
+private:
+  struct Idle
+  {
+    std::unique_ptr<Poco::Net::HTTPClientSession> session;
+    Clock::time_point since;
+  };
+
+  static Poco::Net::Context::Ptr make_context(const Poco::URI& uri, bool ssl_verify)
+  {
+    if (uri.getScheme() != "https")
+      return Poco::Net::Context::Ptr();
+    Poco::Net::Context::Params params;
+    params.verificationMode =
+        ssl_verify ? Poco::Net::Context::VERIFY_STRICT : Poco::Net::Context::VERIFY_NONE;
+    if (ssl_verify)
+      params.caLocation = "/etc/ssl/certs";
+    return new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, params);
+  }
+
+  static std::unique_ptr<Poco::Net::HTTPClientSession> open(const Poco::URI& uri,
+                                                            const Poco::Net::Context::Ptr& context)
+  {
+    if (uri.getScheme() == "https")
+      return std::make_unique<Poco::Net::HTTPSClientSession>(uri.getHost(), uri.getPort(), context);
+    return std::make_unique<Poco::Net::HTTPClientSession>(uri.getHost(), uri.getPort());
+  }
+
+  // Caller holds mutex_; entries are ordered by return time, oldest first
+  void evict_expired(std::vector<Idle>& sessions, Clock::time_point now)
+  {
+    auto fresh = std::find_if(sessions.begin(), sessions.end(),
+                              [&](const Idle& s) { return now - s.since <= idle_timeout_; });
+    evicted_ += static_cast<size_t>(fresh - sessions.begin());
+    sessions.erase(sessions.begin(), fresh);
+  }
+
+  void put_back(const std::string& key, std::unique_ptr<Poco::Net::HTTPClientSession> session)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --leased_;
+    auto& sessions = idle_[key];
+    evict_expired(sessions, Clock::now());
+    if (sessions.size() >= max_idle_per_host_)
+      return;  // over the limit: the session closes here
+    sessions.push_back(Idle{ std::move(session), Clock::now() });
+  }
+
+  void closed_one()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --leased_;
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<Idle>> idle_;
+  Poco::Net::Context::Ptr verify_context_;
+  Poco::Net::Context::Ptr insecure_context_;
+  size_t max_idle_per_host_;
+  std::chrono::milliseconds idle_timeout_;
+  size_t created_{ 0 };
+  size_t reused_{ 0 };
+  size_t evicted_{ 0 };
+  size_t leased_{ 0 };
+};
+
+}  // namespace nano_graphrag
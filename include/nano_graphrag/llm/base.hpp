@@ -1,12 +1,26 @@
 // Abstract base class for LLM strategies
 #pragma once
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
+
+#include "nano_graphrag/utils/ThreadPool.hpp"
+
 namespace nano_graphrag
 {
 
 /**
  * @brief Abstract base class for LLM strategies
+ *
+ * Prompts queued by `prompt_async` run on an executor that calls the virtual
+ * `prompt`. By the time `~ILLMStrategy` runs the derived object is gone, so a
+ * strategy that may have prompts in flight must call `stop_executor()` in its
+ * own destructor; the strategies in this library do.
  */
 class ILLMStrategy
 {
@@ -14,7 +28,10 @@ public:
   /**
    * @brief Virtual destructor
    */
-  virtual ~ILLMStrategy() = default;
+  virtual ~ILLMStrategy()
+  {
+    stop_executor();
+  }
 
   /**
    * @brief Given a user prompt (and optional system prompt), return the LLM completion
@@ -29,6 +46,130 @@ public:
    * @return The model name
    */
   virtual std::string model_name() const = 0;
+
+  /**
+   * @brief Run `prompt` on the strategy's executor and return its completion as a future
+   *
+   * At most `max_in_flight()` prompts run at once; the rest wait in FIFO order.
+   * Exceptions from `prompt` are delivered through the future. The strategy must
+   * outlive the futures it returns.
+   * @param user_prompt The user prompt
+   * @param system_prompt The optional system prompt
+   * @return The LLM completion, once ready
+   */
+  virtual std::future<std::string> prompt_async(const std::string& user_prompt,
+                                                const std::string& system_prompt = "") const
+  {
+    return executor()->submit(
+        [this, user_prompt, system_prompt]() { return prompt(user_prompt, system_prompt); });
+  }
+
+  /**
+   * @brief Prompt every user prompt with the same system prompt, concurrently
+   * @return Completions in input order; the first failure is rethrown once all prompts finished
+   */
+  std::vector<std::string> prompt_batch(const std::vector<std::string>& user_prompts,
+                                        const std::string& system_prompt = "") const
+  {
+    std::vector<std::future<std::string>> pending;
+    pending.reserve(user_prompts.size());
+    for (const auto& user_prompt : user_prompts)
+      pending.push_back(prompt_async(user_prompt, system_prompt));
+    return gather(pending);
+  }
+
+  /**
+   * @brief Prompt every (user prompt, system prompt) pair concurrently
+   * @return Completions in input order; the first failure is rethrown once all prompts finished
+   */
+  std::vector<std::string> prompt_batch(const std::vector<std::pair<std::string, std::string>>& prompts) const
+  {
+    std::vector<std::future<std::string>> pending;
+    pending.reserve(prompts.size());
+    for (const auto& p : prompts)
+      pending.push_back(prompt_async(p.first, p.second));
+    return gather(pending);
+  }
+
+  /**
+   * @brief Max prompts `prompt_async` runs concurrently (default 8)
+   *
+   * Prompts already queued finish on the previous executor before this returns.
+   * Do not call `prompt_batch` from inside a prompt running on the same
+   * strategy: it could wait on itself once every slot is taken.
+   */
+  void set_max_in_flight(size_t n)
+  {
+    std::shared_ptr<ThreadPool> previous;
+    {
+      std::lock_guard<std::mutex> lock(executor_mutex_);
+      max_in_flight_ = std::max<size_t>(n, 1);
+      previous = std::move(executor_);
+    }
+    // drained and joined here, outside the lock, so new prompts start on the next executor meanwhile
+    previous.reset();
+  }
+
+  size_t max_in_flight() const
+  {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    return max_in_flight_;
+  }
+
+protected:
+  /**
+   * @brief Executor of `prompt_async`, started on first use with `max_in_flight()` workers
+   */
+  std::shared_ptr<ThreadPool> executor() const
+  {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    if (!executor_)
+      executor_ = std::make_shared<ThreadPool>(max_in_flight_);
+    return executor_;
+  }
+
+  /**
+   * @brief Finish every queued prompt and stop the executor's workers
+   *
+   * Call first thing in the destructor of a strategy whose `prompt` uses its own
+   * members, so no queued prompt runs on a partly destroyed object. A later
+   * `prompt_async` would start a new executor.
+   */
+  void stop_executor()
+  {
+    std::shared_ptr<ThreadPool> pool;
+    {
+      std::lock_guard<std::mutex> lock(executor_mutex_);
+      pool = std::move(executor_);
+    }
+    pool.reset();
+  }
+
+  static std::vector<std::string> gather(std::vector<std::future<std::string>>& pending)
+  {
+    std::vector<std::string> out(pending.size());
+    std::exception_ptr error;
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+      try
+      {
+        out[i] = pending[i].get();
+      }
+      catch (...)
+      {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+    return out;
+  }
+
+private:
+  mutable std::mutex executor_mutex_;
+  mutable std::shared_ptr<ThreadPool> executor_;
+  size_t max_in_flight_{ 8 };
 };
 
 }  // namespace nano_graphrag
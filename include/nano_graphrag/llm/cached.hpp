@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "nano_graphrag/llm/base.hpp"
+#include "nano_graphrag/storage/JsonKVStorage.hpp"
+#include "nano_graphrag/utils/Hash.hpp"
+#include "nano_graphrag/utils/Log.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Decorator that answers repeated prompts from a persistent response cache
+ *
+ * Completions are keyed by a 128-bit hash of (model, system prompt, user
+ * prompt) and kept in a KV storage, by default a `JsonKVStorage` named
+ * `llm_response_cache` in the working directory (the same namespace Python
+ * nano-graphrag uses). Each record holds the completion (`return`), the model
+ * and its creation time; records older than the TTL count as misses and are
+ * replaced by the next completion. Empty completions are not cached.
+ *
+ * The wrapped strategy is called outside the lock, so concurrent prompts run in
+ * parallel; two concurrent misses on the same prompt both reach the model.
+ *
+ * New completions are buffered in memory (and answered from there) and written
+ * to the storage in batches: once `flush_every()` have accumulated, on
+ * `flush()`, and on destruction. A KV storage such as `JsonKVStorage` rewrites
+ * its whole file per upsert, so this costs one write per batch instead of one
+ * per miss; completions not flushed yet are lost if the process dies.
+ *
+ * All methods are thread-safe.
+ */
+class CachedLLMStrategy : public ILLMStrategy
+{
+public:
+  using Record = std::unordered_map<std::string, std::string>;
+
+  /**
+   * @brief Wrap `inner`, caching in `<dir>/llm_response_cache.json`
+   *
+   * @param inner Strategy that produces completions on a miss
+   * @param dir Working directory of the cache file
+   * @param ttl Max age of a cached completion; zero keeps them forever
+   */
+  CachedLLMStrategy(std::shared_ptr<ILLMStrategy> inner, const std::string& dir,
+                    std::chrono::seconds ttl = std::chrono::seconds{ 0 })
+    : CachedLLMStrategy(std::move(inner), make_storage(dir), ttl)
+  {
+  }
+
+  /**
+   * @brief Wrap `inner`, caching in an existing KV storage
+   */
+  CachedLLMStrategy(std::shared_ptr<ILLMStrategy> inner, std::shared_ptr<BaseKVStorage<Record>> storage,
+                    std::chrono::seconds ttl = std::chrono::seconds{ 0 })
+    : inner_(std::move(inner)), storage_(std::move(storage)), ttl_(ttl)
+  {
+    if (!inner_ || !storage_)
+      throw std::invalid_argument("CachedLLMStrategy requires an inner strategy and a storage");
+  }
+
+  ~CachedLLMStrategy() override
+  {
+    stop_executor();
+    try
+    {
+      flush();
+    }
+    catch (...)
+    {
+      // a destructor must not throw; the buffered completions are lost
+    }
+  }
+
+  std::string prompt(const std::string& user_prompt, const std::string& system_prompt = "") const override
+  {
+    const std::string model = inner_->model_name();
+    const std::string id = key(model, system_prompt, user_prompt);
+    const int64_t now = now_seconds();
+    std::string completion;
+    if (lookup(id, now, completion))
+      return completion;
+    return complete(user_prompt, system_prompt, model, id, now);
+  }
+
+  /**
+   * @brief Cache hits come back as a ready future; only misses take an executor slot
+   */
+  std::future<std::string> prompt_async(const std::string& user_prompt,
+                                        const std::string& system_prompt = "") const override
+  {
+    const std::string model = inner_->model_name();
+    const std::string id = key(model, system_prompt, user_prompt);
+    const int64_t now = now_seconds();
+    std::string completion;
+    if (lookup(id, now, completion))
+    {
+      std::promise<std::string> ready;
+      ready.set_value(std::move(completion));
+      return ready.get_future();
+    }
+    return executor()->submit([this, user_prompt, system_prompt, model, id, now]() {
+      return complete(user_prompt, system_prompt, model, id, now);
+    });
+  }
+
+  std::string model_name() const override
+  {
+    return inner_->model_name();
+  }
+
+  /**
+   * @brief Cache key of a prompt: `llm-` and 32 hex digits
+   */
+  static std::string key(const std::string& model, const std::string& system_prompt,
+                         const std::string& user_prompt)
+  {
+    // length-prefixed fields, so no two triples share a byte string
+    std::string material;
+    material.reserve(model.size() + system_prompt.size() + user_prompt.size() + 48);
+    for (const std::string* field : { &model, &system_prompt, &user_prompt })
+    {
+      material += std::to_string(field->size());
+      material += ':';
+      material += *field;
+    }
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "llm-%016llx%016llx",
+                  static_cast<unsigned long long>(hash_bytes64(material, 0x6C6C6D2D63616368ull)),
+                  static_cast<unsigned long long>(hash_bytes64(material, 0x726573706F6E7365ull)));
+    return buf;
+  }
+
+  /**
+   * @brief Max age of a cached completion; zero keeps them forever
+   */
+  void set_ttl(std::chrono::seconds ttl)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ttl_ = ttl;
+  }
+
+  /**
+   * @brief Write buffered completions to the storage and signal the end of the batch
+   */
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_pending();
+  }
+
+  /**
+   * @brief Buffered completions that trigger a write (default 64); 1 writes every miss
+   */
+  void set_flush_every(size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_every_ = std::max<size_t>(n, 1);
+    if (pending_.size() >= flush_every_)
+      write_pending();
+  }
+
+  size_t flush_every() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flush_every_;
+  }
+
+  /** Prompts answered from the cache since construction. */
+  size_t hits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /** Prompts sent to the wrapped strategy since construction (including expired entries). */
+  size_t misses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  /** Misses caused by an entry older than the TTL. */
+  size_t expired() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return expired_;
+  }
+
+  /** `hits / (hits + misses)`, or 0 before the first prompt. */
+  double hit_rate() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_ + misses_ ? static_cast<double>(hits_) / static_cast<double>(hits_ + misses_) : 0.0;
+  }
+
+  /** Number of cached completions, including expired and not yet flushed ones. */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = storage_->all_keys().size();
+    for (const auto& kv : pending_)
+      n += storage_->get_by_id(kv.first) ? 0 : 1;
+    return n;
+  }
+
+  const std::shared_ptr<ILLMStrategy>& inner() const
+  {
+    return inner_;
+  }
+
+private:
+  static std::shared_ptr<BaseKVStorage<Record>> make_storage(const std::string& dir)
+  {
+    return std::make_shared<JsonKVStorage<Record>>("llm_response_cache", Record{ { "working_dir", dir } });
+  }
+
+  // Counts a hit, miss or expiry; on a hit stores the cached completion in `completion`
+  bool lookup(const std::string& id, int64_t now, std::string& completion) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto buffered = pending_.find(id);
+    auto record =
+        buffered != pending_.end() ? std::optional<Record>(buffered->second) : storage_->get_by_id(id);
+    if (record && record->count("return"))
+    {
+      if (!expired(*record, now))
+      {
+        ++hits_;
+        debug_log("[CachedLLM] hit ", id);
+        completion = record->at("return");
+        return true;
+      }
+      ++expired_;
+    }
+    ++misses_;
+    return false;
+  }
+
+  // Miss path: ask the wrapped strategy outside the lock, then buffer the completion
+  std::string complete(const std::string& user_prompt, const std::string& system_prompt,
+                       const std::string& model, const std::string& id, int64_t now) const
+  {
+    std::string completion = inner_->prompt(user_prompt, system_prompt);
+    if (completion.empty())
+      return completion;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_[id] = Record{ { "return", completion }, { "model", model }, { "created", std::to_string(now) } };
+    if (pending_.size() >= flush_every_)
+      write_pending();
+    return completion;
+  }
+
+  // Caller holds mutex_; one upsert (one file rewrite for JsonKVStorage) for the whole batch
+  void write_pending() const
+  {
+    if (pending_.empty())
+      return;
+    storage_->upsert(pending_);
+    storage_->index_done_callback();
+    pending_.clear();
+  }
+
+  static int64_t now_seconds()
+  {
+    using namespace std::chrono;
+    return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+  }
+
+  // Caller holds mutex_
+  bool expired(const Record& record, int64_t now) const
+  {
+    if (ttl_.count() <= 0)
+      return false;
+    auto it = record.find("created");
+    if (it == record.end())
+      return true;
+    try
+    {
+      return now - std::stoll(it->second) > ttl_.count();
+    }
+    catch (...)
+    {
+      return true;
+    }
+  }
+
+  std::shared_ptr<ILLMStrategy> inner_;
+  std::shared_ptr<BaseKVStorage<Record>> storage_;
+  std::chrono::seconds ttl_;
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, Record> pending_;  // completions not yet written to storage_
+  size_t flush_every_{ 64 };
+  mutable size_t hits_{ 0 };
+  mutable size_t misses_{ 0 };
+  mutable size_t expired_{ 0 };
+};
+
+}  // namespace nano_graphrag
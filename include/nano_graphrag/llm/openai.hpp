@@ -21,6 +21,11 @@ public:
   {
   }
 
+  ~OpenAILLMStrategy() override
+  {
+    stop_executor();
+  }
+
   std::string prompt(const std::string& user_prompt, const std::string& system_prompt = "") const override
   {
     // Use OpenAI Responses API: POST /v1/responses
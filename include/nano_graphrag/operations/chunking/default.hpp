@@ -3,8 +3,15 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <memory>
+#include <future>
+#include <string_view>
+#include <algorithm>
 
 #include "nano_graphrag/utils/Types.hpp"
+#include "nano_graphrag/utils/ThreadPool.hpp"
+#include "nano_graphrag/utils/ByteScan.hpp"
+#include "nano_graphrag/storage/TokenCache.hpp"
 #include "nano_graphrag/operations/chunking/base.hpp"
 
 namespace nano_graphrag
@@ -34,9 +41,13 @@ public:
    */
   std::vector<std::string> chunk(const std::string& doc) const override
   {
-    std::vector<int> tokens = tokenizer_->encode(doc);
+    if (use_offsets())
+    {
+      auto views = chunk_views(doc);
+      return std::vector<std::string>(views.begin(), views.end());
+    }
     std::vector<std::vector<int>> tokens_list;
-    tokens_list.push_back(std::move(tokens));
+    tokens_list.push_back(*document_tokens(doc));
     std::vector<std::string> docs{ doc };
     std::vector<std::string> doc_keys{ std::string("doc") };
     auto chunks = chunking_by_token_size(tokens_list, docs, doc_keys, overlap_size_, chunk_size_);
@@ -66,28 +77,161 @@ public:
     std::vector<TextChunk> results;
     for (size_t index = 0; index < tokens_list.size(); ++index)
     {
-      const auto& tokens = tokens_list[index];
-      std::vector<std::vector<int>> chunk_token;
-      std::vector<int> lengths;
-      std::vector<int> starts;
-      for (int start = 0; start < (int)tokens.size(); start += (max_token_size - overlap_token_size))
-      {
-        std::vector<int> sub(tokens.begin() + start,
-                             tokens.begin() + std::min<int>(start + max_token_size, tokens.size()));
-        chunk_token.push_back(std::move(sub));
-        lengths.push_back(std::min(max_token_size, (int)tokens.size() - start));
-        starts.push_back(start);
-      }
-        std::vector<std::string> chunk_texts =
-          tokenizer_->decode(chunk_token, docs[index], starts, lengths);
-      for (size_t i = 0; i < chunk_texts.size(); ++i)
-      {
-        results.push_back(TextChunk{ lengths[i], chunk_texts[i], doc_keys[index], (int)i });
-      }
+      auto chunks =
+          chunk_tokens(tokens_list[index], docs[index], doc_keys[index], overlap_token_size, max_token_size);
+      results.insert(results.end(), std::make_move_iterator(chunks.begin()),
+                     std::make_move_iterator(chunks.end()));
+    }
+    return results;
+  }
+
+  /**
+   * @brief Slice one tokenized document into overlapping windows and decode them
+   *
+   * @param tokens Token ids of the document
+   * @param doc Original document
+   * @param doc_key Document key
+   * @param overlap_token_size Overlap size between chunks
+   * @param max_token_size Max chunk size
+   * @return std::vector<TextChunk> The document's chunks in order
+   */
+  inline std::vector<TextChunk> chunk_tokens(const std::vector<int>& tokens, const std::string& doc,
+                                             const std::string& doc_key, int overlap_token_size = 128,
+                                             int max_token_size = 1024) const
+  {
+    std::vector<TextChunk> results;
+    std::vector<std::vector<int>> chunk_token;
+    std::vector<int> lengths;
+    std::vector<int> starts;
+    for (int start = 0; start < (int)tokens.size(); start += (max_token_size - overlap_token_size))
+    {
+      std::vector<int> sub(tokens.begin() + start,
+                           tokens.begin() + std::min<int>(start + max_token_size, tokens.size()));
+      chunk_token.push_back(std::move(sub));
+      lengths.push_back(std::min(max_token_size, (int)tokens.size() - start));
+      starts.push_back(start);
+    }
+    std::vector<std::string> chunk_texts = tokenizer_->decode(chunk_token, doc, starts, lengths);
+    results.reserve(chunk_texts.size());
+    for (size_t i = 0; i < chunk_texts.size(); ++i)
+    {
+      results.push_back(TextChunk{ lengths[i], std::move(chunk_texts[i]), doc_key, (int)i });
     }
     return results;
   }
 
+  /**
+   * @brief Chunk a document into views of the original text using token byte offsets
+   *
+   * No token IDs are copied and nothing is decoded; each chunk is a `[begin, end)`
+   * range of `doc`. The views are valid as long as `doc` is.
+   *
+   * @param doc The input document
+   * @return The chunks as views into `doc`
+   */
+  std::vector<std::string_view> chunk_views(const std::string& doc) const
+  {
+    return split_by_offsets(*document_offsets(doc), doc, overlap_size_, chunk_size_);
+  }
+
+  /**
+   * @brief Slice token offsets into overlapping windows of the original document
+   *
+   * Window boundaries that fall inside a multi-byte UTF-8 character are moved
+   * forward to the next character boundary.
+   *
+   * @param offsets Byte ranges of the document's tokens
+   * @param doc Original document
+   * @param overlap_token_size Overlap size between chunks
+   * @param max_token_size Max chunk size
+   * @param lengths Optional output receiving the token count of each chunk
+   * @return std::vector<std::string_view> The chunk views, in order
+   */
+  static std::vector<std::string_view> split_by_offsets(const std::vector<TokenOffset>& offsets,
+                                                        std::string_view doc, int overlap_token_size = 128,
+                                                        int max_token_size = 1024,
+                                                        std::vector<int>* lengths = nullptr)
+  {
+    std::vector<std::string_view> views;
+    const int n = static_cast<int>(offsets.size());
+    for (int start = 0; start < n; start += (max_token_size - overlap_token_size))
+    {
+      int last = std::min(start + max_token_size, n) - 1;
+      size_t begin = utf8_boundary(doc, offsets[start].begin);
+      size_t end = std::max(begin, utf8_boundary(doc, offsets[last].end));
+      views.push_back(doc.substr(begin, end - begin));
+      if (lengths)
+        lengths->push_back(last - start + 1);
+    }
+    return views;
+  }
+
+  /**
+   * @brief Enable or disable offset-based chunking
+   *
+   * When enabled (the default) and the tokenizer supports offsets, chunks are cut
+   * directly from the document by token byte ranges; otherwise token windows are
+   * copied and decoded through the tokenizer.
+   */
+  void set_offset_mode(bool enabled)
+  {
+    offset_mode_ = enabled;
+  }
+
+  /**
+   * @brief Whether chunks are currently produced from token offsets
+   */
+  bool use_offsets() const
+  {
+    return offset_mode_ && tokenizer_ && tokenizer_->supports_offsets();
+  }
+
+  /**
+   * @brief Set the number of worker threads used by `get_chunks`
+   *
+   * With more than one thread, each document is tokenized, sliced and decoded
+   * as its own task on a thread pool. Output (chunk ids, order indices and map
+   * contents) is the same as the sequential path.
+   *
+   * @param n Thread count (default: all hardware threads); 1 keeps the sequential path, 0 means all
+   * hardware threads
+   */
+  void set_num_threads(size_t n)
+  {
+    if (n == 0)
+      n = hardware_threads();
+    num_threads_ = n;
+    pool_.reset();
+  }
+
+  /**
+   * @brief Get the number of worker threads used by `get_chunks`
+   */
+  size_t num_threads() const
+  {
+    return num_threads_;
+  }
+
+  /**
+   * @brief Reuse and record per-document tokenization through `cache`
+   *
+   * Documents found in the cache are chunked without running the tokenizer, so
+   * re-chunking with different sizes only pays for slicing. The cache is bypassed
+   * when it was opened for a different tokenizer. Pass null to disable.
+   */
+  void set_token_cache(std::shared_ptr<TokenCache> cache)
+  {
+    token_cache_ = std::move(cache);
+  }
+
+  /**
+   * @brief Get the token cache, or null when caching is disabled
+   */
+  const std::shared_ptr<TokenCache>& token_cache() const
+  {
+    return token_cache_;
+  }
+
   /**
    * @brief Get chunks from new documents
    *
@@ -110,21 +254,112 @@ public:
       keys.push_back(kv.first);
       docs.push_back(kv.second.at("content"));
     }
-    std::vector<std::vector<int>> tokens;
-    tokens.reserve(docs.size());
-    for (const auto& d : docs)
-      tokens.push_back(tokenizer_->encode(d));
-    auto chunks = chunking_by_token_size(tokens, docs, keys, overlap_token_size, max_token_size);
-    for (const auto& chunk : chunks)
+    std::vector<TextChunk> chunks;
+    if (num_threads_ > 1 && docs.size() > 1)
+    {
+      // One task per document; results are gathered in document order
+      if (!pool_)
+        pool_ = std::make_shared<ThreadPool>(num_threads_);
+      std::vector<std::future<std::vector<TextChunk>>> pending;
+      pending.reserve(docs.size());
+      for (size_t i = 0; i < docs.size(); ++i)
+      {
+        pending.push_back(pool_->submit([this, &docs, &keys, i, overlap_token_size, max_token_size]() {
+          return chunk_document(docs[i], keys[i], overlap_token_size, max_token_size);
+        }));
+      }
+      for (auto& f : pending)
+      {
+        auto doc_chunks = f.get();
+        chunks.insert(chunks.end(), std::make_move_iterator(doc_chunks.begin()),
+                      std::make_move_iterator(doc_chunks.end()));
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < docs.size(); ++i)
+      {
+        auto doc_chunks = chunk_document(docs[i], keys[i], overlap_token_size, max_token_size);
+        chunks.insert(chunks.end(), std::make_move_iterator(doc_chunks.begin()),
+                      std::make_move_iterator(doc_chunks.end()));
+      }
+    }
+    for (auto& chunk : chunks)
     {
       // simple md5-like id: use std::hash
       std::hash<std::string> h;
       std::string id = "chunk-" + std::to_string(h(chunk.content));
-      inserting_chunks.emplace(id, chunk);
+      inserting_chunks.emplace(std::move(id), std::move(chunk));
     }
     return inserting_chunks;
   }
 
+protected:
+  /**
+   * @brief Chunk one document, by offsets when available, otherwise by decoding token windows
+   *
+   * Subclasses override this to change where chunks are cut; `get_chunks` handles
+   * threading, ordering and ids.
+   */
+  virtual std::vector<TextChunk> chunk_document(const std::string& doc, const std::string& doc_key,
+                                                int overlap_token_size, int max_token_size) const
+  {
+    if (!use_offsets())
+      return chunk_tokens(*document_tokens(doc), doc, doc_key, overlap_token_size, max_token_size);
+    std::vector<int> lengths;
+    auto views = split_by_offsets(*document_offsets(doc), doc, overlap_token_size, max_token_size, &lengths);
+    std::vector<TextChunk> results;
+    results.reserve(views.size());
+    for (size_t i = 0; i < views.size(); ++i)
+      results.push_back(TextChunk{ lengths[i], std::string(views[i]), doc_key, (int)i });
+    return results;
+  }
+
+  /**
+   * @brief Token byte offsets of `doc`, from the token cache when possible
+   */
+  std::shared_ptr<const std::vector<TokenOffset>> document_offsets(const std::string& doc) const
+  {
+    if (!cache_usable())
+      return std::make_shared<const std::vector<TokenOffset>>(tokenizer_->encode_offsets(doc));
+    auto entry = token_cache_->find(doc);
+    if (!entry || (entry->offsets.empty() && !entry->ids.empty()))
+    {
+      TokenCache::Entry fresh;
+      fresh.offsets = tokenizer_->encode_offsets(doc);
+      entry = token_cache_->insert(doc, std::move(fresh));
+    }
+    return std::shared_ptr<const std::vector<TokenOffset>>(entry, &entry->offsets);
+  }
+
+  /**
+   * @brief Token ids of `doc`, from the token cache when possible
+   */
+  std::shared_ptr<const std::vector<int>> document_tokens(const std::string& doc) const
+  {
+    if (!cache_usable())
+      return std::make_shared<const std::vector<int>>(tokenizer_->encode(doc));
+    auto entry = token_cache_->find(doc);
+    if (!entry || (entry->ids.empty() && !entry->offsets.empty()))
+    {
+      TokenCache::Entry fresh;
+      fresh.ids = tokenizer_->encode(doc);
+      entry = token_cache_->insert(doc, std::move(fresh));
+    }
+    return std::shared_ptr<const std::vector<int>>(entry, &entry->ids);
+  }
+
+private:
+  bool cache_usable() const
+  {
+    return token_cache_ && token_cache_->tokenizer_name() == tokenizer_->name();
+  }
+
+  bool offset_mode_{ true };
+  size_t num_threads_{ hardware_threads() };
+  std::shared_ptr<ThreadPool> pool_;
+  std::shared_ptr<TokenCache> token_cache_;
+
 };
 
 }  // namespace nano_graphrag
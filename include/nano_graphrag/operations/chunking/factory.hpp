@@ -2,6 +2,7 @@
 #include <memory>
 #include "nano_graphrag/operations/chunking/base.hpp"
 #include "nano_graphrag/operations/chunking/default.hpp"
+#include "nano_graphrag/operations/chunking/separator.hpp"
 
 namespace nano_graphrag
 {
@@ -12,6 +13,7 @@ namespace nano_graphrag
 enum class ChunkingStrategyType
 {
   Default,
+  Separator,  // paragraph/line/sentence-aware packing
   // Add more strategies here when available
 };
 
@@ -27,6 +29,8 @@ inline std::unique_ptr<IChunkingStrategy> create_chunking_strategy(ChunkingStrat
   {
     case ChunkingStrategyType::Default:
       return std::make_unique<DefaultChunkingStrategy>();
+    case ChunkingStrategyType::Separator:
+      return std::make_unique<SeparatorChunkingStrategy>();
     default:
       return nullptr;
   }
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nano_graphrag/utils/ByteScan.hpp"
+#include "nano_graphrag/utils/Types.hpp"
+#include "nano_graphrag/operations/chunking/default.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Chunking strategy that cuts at paragraph, line and sentence boundaries
+ *
+ * Boundaries are located with a vectorized scan for newlines and sentence
+ * terminators. The document is split recursively: into paragraphs, then lines,
+ * then sentences, only as far as needed for every segment to fit in the chunk
+ * size; a segment that is still too long is cut by token offsets. Segments are
+ * then packed greedily up to the chunk size, and each chunk starts with the
+ * trailing whole segments of the previous one that fit in the overlap.
+ *
+ * The document is tokenized in one pass and every count is read from it. With a
+ * tokenizer that supports offsets, the whole document's offsets are taken from
+ * the token cache when one is set (see `set_token_cache`) and a range counts the
+ * tokens that start in it. Otherwise each piece between two consecutive
+ * boundaries is counted once with `count_tokens` (not cached) and a range sums
+ * its pieces.
+ */
+class SeparatorChunkingStrategy : public DefaultChunkingStrategy
+{
+public:
+  /**
+   * @brief Boundary strength; a cut of a given level is also a cut of every lower level
+   */
+  enum Level : int
+  {
+    Sentence = 1,
+    Line = 2,
+    Paragraph = 3
+  };
+
+  /**
+   * @brief Chunk the document at natural boundaries
+   *
+   * @param doc The input document
+   * @return The chunks as a vector of strings
+   */
+  std::vector<std::string> chunk(const std::string& doc) const override
+  {
+    auto chunks = chunk_document(doc, "doc", overlap_size_, chunk_size_);
+    std::vector<std::string> out;
+    out.reserve(chunks.size());
+    for (auto& ch : chunks)
+      out.push_back(std::move(ch.content));
+    return out;
+  }
+
+  /**
+   * @brief Cut positions in `text` with their level, in ascending order
+   *
+   * A cut sits at the start of the whitespace run that follows a sentence
+   * terminator (`.`, `!`, `?`) or contains a newline; leading whitespace stays
+   * with the next segment, which matches how BPE tokenizers attach it.
+   */
+  static std::vector<std::pair<size_t, int>> find_boundaries(std::string_view text)
+  {
+    std::vector<std::pair<size_t, int>> cuts;
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    size_t last_run = std::string_view::npos;
+    for_each_byte_of<'\n', '.', '!', '?'>(text, [&](size_t pos) {
+      size_t run;  // start of the whitespace run this candidate belongs to
+      if (text[pos] == '\n')
+      {
+        run = pos;
+        while (run > 0 && is_space(text[run - 1]))
+          --run;
+      }
+      else
+      {
+        if (pos + 1 >= text.size() || !is_space(text[pos + 1]))
+          return;
+        run = pos + 1;
+      }
+      if (run == 0 || run == last_run)
+        return;
+      last_run = run;
+      size_t end = run;
+      int newlines = 0;
+      while (end < text.size() && is_space(text[end]))
+        newlines += text[end++] == '\n';
+      if (end == text.size())
+        return;
+      int level = newlines >= 2 ? Paragraph : newlines == 1 ? Line : Sentence;
+      if (!cuts.empty() && cuts.back().first == run)
+        cuts.back().second = std::max(cuts.back().second, level);
+      else
+        cuts.emplace_back(run, level);
+    });
+    return cuts;
+  }
+
+protected:
+  /**
+   * @brief A `[begin, end)` byte range of the document and its token count
+   */
+  struct Segment
+  {
+    size_t begin;
+    size_t end;
+    int tokens;
+  };
+
+  std::vector<TextChunk> chunk_document(const std::string& doc, const std::string& doc_key,
+                                        int overlap_token_size, int max_token_size) const override
+  {
+    std::vector<Segment> segments;
+    auto cuts = find_boundaries(doc);
+    RangeCounter counter = count_document(doc, cuts);
+    split(doc, cuts, counter, 0, doc.size(), Paragraph, max_token_size, segments);
+    return pack(doc, segments, doc_key, overlap_token_size, max_token_size);
+  }
+
+private:
+  /**
+   * @brief Token counts of byte ranges of one document, read from a single tokenization
+   *
+   * With offsets a range holds the tokens that start in it; otherwise the pieces
+   * between `bounds` were counted once and a range sums them. Either way, counts
+   * of adjacent ranges add up.
+   */
+  struct RangeCounter
+  {
+    std::shared_ptr<const std::vector<TokenOffset>> offsets;
+    std::vector<size_t> bounds;  // piece boundaries (without offsets)
+    std::vector<int> before;     // tokens before each bound
+
+    int count(size_t begin, size_t end) const
+    {
+      if (offsets)
+      {
+        auto starts_before = [](const TokenOffset& t, size_t pos) { return t.begin < pos; };
+        auto lo = std::lower_bound(offsets->begin(), offsets->end(), begin, starts_before);
+        auto hi = std::lower_bound(lo, offsets->end(), end, starts_before);
+        return static_cast<int>(hi - lo);
+      }
+      auto at = [this](size_t pos) {
+        auto it = std::lower_bound(bounds.begin(), bounds.end(), pos);
+        return before[static_cast<size_t>(it - bounds.begin())];
+      };
+      return at(end) - at(begin);
+    }
+  };
+
+  RangeCounter count_document(const std::string& doc, const std::vector<std::pair<size_t, int>>& cuts) const
+  {
+    RangeCounter counter;
+    if (tokenizer_->supports_offsets())
+    {
+      counter.offsets = document_offsets(doc);
+      return counter;
+    }
+    counter.bounds.reserve(cuts.size() + 2);
+    counter.before.reserve(cuts.size() + 2);
+    counter.bounds.push_back(0);
+    counter.before.push_back(0);
+    for (size_t i = 0; i <= cuts.size(); ++i)
+    {
+      size_t begin = counter.bounds.back();
+      size_t end = i < cuts.size() ? cuts[i].first : doc.size();
+      std::string_view piece = std::string_view(doc).substr(begin, end - begin);
+      counter.before.push_back(counter.before.back() + static_cast<int>(tokenizer_->count_tokens(piece)));
+      counter.bounds.push_back(end);
+    }
+    return counter;
+  }
+
+  /**
+   * @brief Split `[begin, end)` at cuts of `level` or stronger until every piece fits in `max_tokens`
+   */
+  void split(std::string_view doc, const std::vector<std::pair<size_t, int>>& cuts,
+             const RangeCounter& counter, size_t begin, size_t end, int level, int max_tokens,
+             std::vector<Segment>& out) const
+  {
+    if (begin >= end)
+      return;
+    int tokens = counter.count(begin, end);
+    if (tokens <= max_tokens)
+    {
+      out.push_back(Segment{ begin, end, tokens });
+      return;
+    }
+    if (level < Sentence)
+    {
+      split_by_tokens(doc, counter, begin, end, max_tokens, out);
+      return;
+    }
+    auto lo = std::upper_bound(cuts.begin(), cuts.end(), std::make_pair(begin, 1 << 30));
+    size_t piece_begin = begin;
+    for (auto it = lo; it != cuts.end() && it->first < end; ++it)
+    {
+      if (it->second < level)
+        continue;
+      split(doc, cuts, counter, piece_begin, it->first, level - 1, max_tokens, out);
+      piece_begin = it->first;
+    }
+    split(doc, cuts, counter, piece_begin, end, level - 1, max_tokens, out);
+  }
+
+  /**
+   * @brief Last resort for text without usable boundaries: consecutive windows of `max_tokens` tokens
+   */
+  void split_by_tokens(std::string_view doc, const RangeCounter& counter, size_t begin, size_t end,
+                       int max_tokens, std::vector<Segment>& out) const
+  {
+    if (!counter.offsets)
+    {
+      out.push_back(Segment{ begin, end, counter.count(begin, end) });
+      return;
+    }
+    // the document's offsets of the tokens starting in the range, relative to it
+    std::string_view text = doc.substr(begin, end - begin);
+    auto starts_before = [](const TokenOffset& t, size_t pos) { return t.begin < pos; };
+    auto lo = std::lower_bound(counter.offsets->begin(), counter.offsets->end(), begin, starts_before);
+    auto hi = std::lower_bound(lo, counter.offsets->end(), end, starts_before);
+    std::vector<TokenOffset> local;
+    local.reserve(static_cast<size_t>(hi - lo));
+    for (auto it = lo; it != hi; ++it)
+      local.push_back(TokenOffset{ it->begin - begin, std::min(it->end, end) - begin });
+    std::vector<int> lengths;
+    auto views = split_by_offsets(local, text, 0, max_tokens, &lengths);
+    for (size_t i = 0; i < views.size(); ++i)
+    {
+      size_t b = begin + static_cast<size_t>(views[i].data() - text.data());
+      size_t e = i + 1 < views.size() ? begin + static_cast<size_t>(views[i + 1].data() - text.data()) : end;
+      out.push_back(Segment{ b, e, lengths[i] });
+    }
+  }
+
+  /**
+   * @brief Greedily pack segments into chunks of at most `max_tokens`, overlapping by whole segments
+   */
+  static std::vector<TextChunk> pack(const std::string& doc, const std::vector<Segment>& segments,
+                                     const std::string& doc_key, int overlap_tokens, int max_tokens)
+  {
+    std::vector<TextChunk> results;
+    size_t i = 0;
+    while (i < segments.size())
+    {
+      size_t j = i;
+      int total = 0;
+      while (j < segments.size() && (j == i || total + segments[j].tokens <= max_tokens))
+        total += segments[j++].tokens;
+
+      size_t begin = segments[i].begin;
+      size_t end = segments[j - 1].end;
+      while (begin < end && std::isspace(static_cast<unsigned char>(doc[begin])))
+        ++begin;
+      while (end > begin && std::isspace(static_cast<unsigned char>(doc[end - 1])))
+        --end;
+      if (end > begin)
+        results.push_back(TextChunk{ total, doc.substr(begin, end - begin), doc_key, (int)results.size() });
+      if (j == segments.size())
+        break;
+
+      // start the next chunk with the trailing segments that fit in the overlap
+      size_t k = j;
+      int overlap = 0;
+      while (k - 1 > i && overlap + segments[k - 1].tokens <= overlap_tokens)
+        overlap += segments[--k].tokens;
+      i = k;
+    }
+    return results;
+  }
+};
+
+}  // namespace nano_graphrag
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nano_graphrag/utils/ByteScan.hpp"
+#include "nano_graphrag/utils/Types.hpp"
+#include "nano_graphrag/operations/chunking/default.hpp"
+#include "nano_graphrag/operations/tokenize/base.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Token-window chunker that reads a document incrementally from a stream
+ *
+ * Produces the same overlapping windows as `DefaultChunkingStrategy` in offset
+ * mode, but holds at most one window of text plus one read block in memory, so
+ * inputs larger than RAM can be chunked. Each block is tokenized up to its last
+ * space that follows an ASCII letter: pre-tokenizers never continue a letter run
+ * into a space (whereas e.g. tiktoken merges runs of newlines, or punctuation
+ * with the newlines after it), so token boundaries do not depend on the block
+ * size and the chunks equal the whole-document ones. Only a run longer than a
+ * block without such a point is cut elsewhere. Requires a tokenizer that
+ * supports offsets.
+ */
+class StreamingChunker
+{
+public:
+  /**
+   * @brief Callback receiving each chunk as soon as its window is complete
+   */
+  using ChunkCallback = std::function<void(TextChunk&&)>;
+
+  /**
+   * @brief Constructor
+   *
+   * @param tokenizer Tokenizer used to measure windows; must support offsets
+   * @param chunk_size Max tokens per chunk
+   * @param overlap_size Overlap between consecutive chunks
+   * @param block_bytes Bytes read from the stream per step
+   */
+  StreamingChunker(std::shared_ptr<ITokenizerStrategy> tokenizer, int chunk_size = 1024,
+                   int overlap_size = 128, size_t block_bytes = 1 << 16)
+    : tokenizer_(std::move(tokenizer))
+    , chunk_size_(chunk_size)
+    , overlap_size_(overlap_size)
+    , block_bytes_(std::max<size_t>(block_bytes, 64))
+  {
+    if (!tokenizer_ || !tokenizer_->supports_offsets())
+      throw std::invalid_argument("StreamingChunker requires a tokenizer that supports offsets");
+    if (chunk_size_ <= overlap_size_ || overlap_size_ < 0)
+      throw std::invalid_argument("StreamingChunker requires 0 <= overlap_size < chunk_size");
+  }
+
+  /**
+   * @brief Chunk everything readable from `in`
+   *
+   * @param in Input stream, read until EOF
+   * @param doc_key Value for each chunk's `full_doc_id`
+   * @param emit Called once per chunk, in order
+   * @return Number of chunks emitted
+   */
+  size_t chunk_stream(std::istream& in, const std::string& doc_key, const ChunkCallback& emit) const
+  {
+    State st;
+    std::string block(block_bytes_, '\0');
+    std::string carry;  // bytes read but not yet tokenized (after the last cut point)
+    while (in)
+    {
+      in.read(&block[0], static_cast<std::streamsize>(block.size()));
+      size_t got = static_cast<size_t>(in.gcount());
+      if (got == 0)
+        break;
+      carry.append(block, 0, got);
+      size_t cut = cut_point(carry);
+      if (cut == 0)
+        continue;
+      feed(st, std::string_view(carry).substr(0, cut), doc_key, emit);
+      carry.erase(0, cut);
+    }
+    if (!carry.empty())
+      feed(st, carry, doc_key, emit);
+    finish(st, doc_key, emit);
+    return st.emitted;
+  }
+
+  /**
+   * @brief Chunk a file on disk
+   *
+   * @param path File path
+   * @param doc_key Value for each chunk's `full_doc_id`
+   * @param emit Called once per chunk, in order
+   * @return Number of chunks emitted
+   */
+  size_t chunk_file(const std::string& path, const std::string& doc_key, const ChunkCallback& emit) const
+  {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+      throw std::runtime_error("cannot open " + path);
+    return chunk_stream(in, doc_key, emit);
+  }
+
+private:
+  /**
+   * @brief Text of the window currently being filled and its token offsets (relative to `text`)
+   */
+  struct State
+  {
+    std::string text;
+    std::vector<TokenOffset> offsets;
+    size_t emitted{ 0 };
+  };
+
+  /**
+   * @brief Length of the prefix of `s` that can be tokenized without seeing more input
+   *
+   * Cuts before the last space that follows an ASCII letter; a tail longer than a
+   * block without one is cut at a UTF-8 character boundary so memory stays bounded.
+   */
+  size_t cut_point(const std::string& s) const
+  {
+    auto is_alpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    for (size_t pos = s.rfind(' '); pos != std::string::npos && pos > 0; pos = s.rfind(' ', pos - 1))
+      if (is_alpha(s[pos - 1]))
+        return pos;
+    if (s.size() < block_bytes_)
+      return 0;
+    size_t pos = s.size() - 1;
+    while (pos > 0 && (static_cast<unsigned char>(s[pos]) & 0xC0) == 0x80)
+      --pos;
+    return pos > 0 ? pos : s.size();
+  }
+
+  void feed(State& st, std::string_view piece, const std::string& doc_key, const ChunkCallback& emit) const
+  {
+    const size_t base = st.text.size();
+    st.text.append(piece);
+    for (const auto& off : tokenizer_->encode_offsets(std::string(piece)))
+      st.offsets.push_back(TokenOffset{ base + off.begin, base + off.end });
+    while (static_cast<int>(st.offsets.size()) >= chunk_size_)
+      emit_window(st, doc_key, emit);
+  }
+
+  void finish(State& st, const std::string& doc_key, const ChunkCallback& emit) const
+  {
+    while (!st.offsets.empty())
+      emit_window(st, doc_key, emit);
+  }
+
+  /**
+   * @brief Emit the window starting at the first buffered token and advance by one stride
+   */
+  void emit_window(State& st, const std::string& doc_key, const ChunkCallback& emit) const
+  {
+    const size_t count = std::min(st.offsets.size(), static_cast<size_t>(chunk_size_));
+    size_t begin = utf8_boundary(st.text, st.offsets.front().begin);
+    size_t end = std::max(begin, utf8_boundary(st.text, st.offsets[count - 1].end));
+    emit(TextChunk{ static_cast<int>(count), st.text.substr(begin, end - begin), doc_key,
+                    static_cast<int>(st.emitted++) });
+
+    const size_t stride = static_cast<size_t>(chunk_size_ - overlap_size_);
+    if (st.offsets.size() <= stride)
+    {
+      st.offsets.clear();
+      st.text.clear();
+      return;
+    }
+    const size_t shift = st.offsets[stride].begin;
+    st.offsets.erase(st.offsets.begin(), st.offsets.begin() + static_cast<std::ptrdiff_t>(stride));
+    for (auto& off : st.offsets)
+    {
+      off.begin -= shift;
+      off.end -= shift;
+    }
+    st.text.erase(0, shift);
+  }
+
+  std::shared_ptr<ITokenizerStrategy> tokenizer_;
+  int chunk_size_;
+  int overlap_size_;
+  size_t block_bytes_;
+};
+
+}  // namespace nano_graphrag
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nano_graphrag/utils/ByteScan.hpp"
+#include "nano_graphrag/utils/Hash.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief MinHash / LSH settings
+ */
+struct MinHashParam
+{
+  int num_perm{ 128 };      // signature length
+  int bands{ 32 };          // LSH bands; rows per band = num_perm / bands
+  int shingle_words{ 3 };   // words per shingle
+  double threshold{ 0.8 };  // estimated Jaccard similarity at or above which texts are duplicates
+};
+
+/**
+ * @brief Near-duplicate detector for text chunks using MinHash signatures and LSH banding
+ *
+ * Texts are reduced to hashed word shingles; each signature slot keeps the
+ * minimum of one hash permutation over the shingles. Signatures are split into
+ * bands, and texts sharing any band bucket become candidates. A candidate is a
+ * duplicate when the fraction of equal signature slots (the Jaccard estimate)
+ * reaches the threshold. Lookups cost one bucket probe per band rather than a
+ * scan over all stored texts.
+ */
+class MinHashDeduplicator
+{
+public:
+  using Signature = std::vector<uint64_t>;
+
+  explicit MinHashDeduplicator(const MinHashParam& param = {})
+    : param_(param)
+  {
+    param_.num_perm = std::max(param_.num_perm, 1);
+    param_.bands = std::clamp(param_.bands, 1, param_.num_perm);
+    param_.shingle_words = std::max(param_.shingle_words, 1);
+    rows_ = param_.num_perm / param_.bands;
+    seeds_.reserve(static_cast<size_t>(param_.num_perm));
+    for (int i = 0; i < param_.num_perm; ++i)
+      seeds_.push_back(mix64(0x5bd1e995ull + static_cast<uint64_t>(i)));
+    buckets_.resize(static_cast<size_t>(param_.bands));
+  }
+
+  const MinHashParam& param() const
+  {
+    return param_;
+  }
+
+  /**
+   * @brief MinHash signature of a text over its word shingles
+   */
+  Signature signature(std::string_view text) const
+  {
+    std::vector<uint64_t> word_hashes;
+    for_each_word(text,
+                  [&](size_t begin, size_t end) { word_hashes.push_back(fnv1a64(text.substr(begin, end - begin))); });
+
+    std::vector<uint64_t> shingles;
+    const size_t k = static_cast<size_t>(param_.shingle_words);
+    if (word_hashes.size() <= k)
+    {
+      uint64_t h = 0;
+      for (uint64_t w : word_hashes)
+        h = mix64(h ^ w);
+      shingles.push_back(h);
+    }
+    else
+    {
+      shingles.reserve(word_hashes.size() - k + 1);
+      for (size_t i = 0; i + k <= word_hashes.size(); ++i)
+      {
+        uint64_t h = 0;
+        for (size_t j = 0; j < k; ++j)
+          h = mix64(h ^ word_hashes[i + j]);
+        shingles.push_back(h);
+      }
+    }
+
+    Signature sig(seeds_.size(), std::numeric_limits<uint64_t>::max());
+    for (uint64_t sh : shingles)
+      for (size_t i = 0; i < seeds_.size(); ++i)
+        sig[i] = std::min(sig[i], mix64(sh ^ seeds_[i]));
+    return sig;
+  }
+
+  /**
+   * @brief Fraction of equal slots between two signatures (estimated Jaccard similarity)
+   */
+  static double similarity(const Signature& a, const Signature& b)
+  {
+    if (a.empty() || a.size() != b.size())
+      return 0.0;
+    size_t same = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+      same += a[i] == b[i];
+    return static_cast<double>(same) / static_cast<double>(a.size());
+  }
+
+  /**
+   * @brief Find the most similar stored text at or above the threshold
+   * @return Its id, or nothing if `text` is not a near-duplicate
+   */
+  std::optional<std::string> find_duplicate(std::string_view text) const
+  {
+    return find_duplicate(signature(text));
+  }
+
+  std::optional<std::string> find_duplicate(const Signature& sig) const
+  {
+    std::optional<std::string> best;
+    double best_sim = param_.threshold;
+    std::vector<size_t> seen;
+    for (int b = 0; b < param_.bands; ++b)
+    {
+      auto it = buckets_[static_cast<size_t>(b)].find(band_key(sig, b));
+      if (it == buckets_[static_cast<size_t>(b)].end())
+        continue;
+      for (size_t entry : it->second)
+      {
+        if (std::find(seen.begin(), seen.end(), entry) != seen.end())
+          continue;
+        seen.push_back(entry);
+        double sim = similarity(sig, entries_[entry].second);
+        if (sim >= best_sim)
+        {
+          best_sim = sim;
+          best = entries_[entry].first;
+        }
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Index a text under `id` so later lookups can match it
+   */
+  void add(const std::string& id, std::string_view text)
+  {
+    add(id, signature(text));
+  }
+
+  void add(const std::string& id, Signature sig)
+  {
+    const size_t entry = entries_.size();
+    for (int b = 0; b < param_.bands; ++b)
+      buckets_[static_cast<size_t>(b)][band_key(sig, b)].push_back(entry);
+    entries_.emplace_back(id, std::move(sig));
+  }
+
+  /**
+   * @brief Return the id of a stored near-duplicate of `text`, or index `text` under `id` if there is none
+   */
+  std::optional<std::string> check_and_add(const std::string& id, std::string_view text)
+  {
+    Signature sig = signature(text);
+    auto dup = find_duplicate(sig);
+    if (!dup)
+      add(id, std::move(sig));
+    return dup;
+  }
+
+  /**
+   * @brief Number of indexed texts
+   */
+  size_t size() const
+  {
+    return entries_.size();
+  }
+
+private:
+  uint64_t band_key(const Signature& sig, int band) const
+  {
+    uint64_t h = static_cast<uint64_t>(band);
+    const size_t begin = static_cast<size_t>(band * rows_);
+    for (size_t r = begin; r < begin + static_cast<size_t>(rows_); ++r)
+      h = mix64(h ^ sig[r]);
+    return h;
+  }
+
+  MinHashParam param_;
+  int rows_{ 1 };
+  std::vector<uint64_t> seeds_;
+  std::vector<std::pair<std::string, Signature>> entries_;
+  std::vector<std::unordered_map<uint64_t, std::vector<size_t>>> buckets_;
+};
+
+}  // namespace nano_graphrag
@@ -1,6 +1,10 @@
 #pragma once
+#include <cstddef>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "nano_graphrag/utils/Parallel.hpp"
 
 namespace nano_graphrag
 {
@@ -18,8 +22,19 @@ enum class TokenizerType
   Tiktoken
 };
 
+/**
+ * @brief Byte range `[begin, end)` of one token in the encoded text
+ */
+struct TokenOffset
+{
+  size_t begin{ 0 };
+  size_t end{ 0 };
+};
+
 /**
  * @brief Abstract base class for tokenizer strategies
+ *
+ * Implementations must be safe to call concurrently from multiple threads.
  */
 class ITokenizerStrategy
 {
@@ -36,6 +51,37 @@ public:
    */
   virtual std::vector<int> encode(const std::string& text) const = 0;
 
+  /**
+   * @brief Number of tokens in a text, for budget checks that do not need the IDs
+   *
+   * The default encodes and takes the size; implementations override it with a
+   * count-only path.
+   *
+   * @param text The input text
+   * @return The token count
+   */
+  virtual size_t count_tokens(std::string_view text) const
+  {
+    return encode(std::string(text)).size();
+  }
+
+  /**
+   * @brief Encode many texts, spreading them across threads
+   * @param texts The input texts
+   * @param num_threads Worker threads; 0 means all hardware threads
+   * @return The token IDs of each text, in input order
+   */
+  virtual std::vector<std::vector<int>> encode_batch(const std::vector<std::string>& texts,
+                                                     size_t num_threads = 0) const
+  {
+    std::vector<std::vector<int>> out(texts.size());
+    parallel_for(0, texts.size(), num_threads, [&](size_t lo, size_t hi, size_t) {
+      for (size_t i = lo; i < hi; ++i)
+        out[i] = encode(texts[i]);
+    });
+    return out;
+  }
+
   /**
    * @brief Given a list of token ID sequences, return their decoded texts
    * @param tokens_list The list of token ID sequences
@@ -55,11 +101,54 @@ public:
                                           const std::string& doc, const std::vector<int>& starts,
                                           const std::vector<int>& lengths) const = 0;
 
+  /**
+   * @brief Whether `encode_offsets` is implemented
+   * @return True if the tokenizer can report per-token byte offsets
+   */
+  virtual bool supports_offsets() const
+  {
+    return false;
+  }
+
+  /**
+   * @brief Given a text, return the byte range of each token instead of its ID
+   *
+   * Offsets are ascending and index into `text`; chunkers use them to cut chunks
+   * as ranges of the original document without decoding tokens back to text.
+   *
+   * @param text The input text
+   * @return One offset per token, in token order
+   */
+  virtual std::vector<TokenOffset> encode_offsets(const std::string& /*text*/) const
+  {
+    throw std::logic_error("tokenizer does not report token offsets");
+  }
+
   /**
    * @brief Get the tokenizer type
    * @return The tokenizer type
    */
   virtual TokenizerType type() const = 0;
+
+  /**
+   * @brief Stable identity of the tokenizer and its vocabulary
+   *
+   * Used to key persisted tokenization results; tokenizers whose output depends
+   * on more than `type()` (e.g. the encoding model) must include that here.
+   */
+  virtual std::string name() const
+  {
+    switch (type())
+    {
+      case TokenizerType::Simple:
+        return "simple";
+      case TokenizerType::OpenAI:
+        return "openai";
+      case TokenizerType::Tiktoken:
+        return "tiktoken";
+    }
+    return "unknown";
+  }
 };
 
 }  // namespace nano_graphrag
@@ -1,7 +1,9 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "nano_graphrag/operations/tokenize/base.hpp"
+#include "nano_graphrag/utils/ByteScan.hpp"
 
 namespace nano_graphrag
 {
@@ -19,27 +21,37 @@ public:
    */
   std::vector<int> encode(const std::string& text) const override
   {
-    std::vector<int> tokens;
-    tokens.reserve(text.size() / 4);
-    bool in_word = false;
-    for (char c : text)
-    {
-      if (c == ' ' || c == '\n' || c == '\t')
-      {
-        if (in_word)
-        {
-          tokens.push_back(1);
-          in_word = false;
-        }
-      }
-      else
-      {
-        in_word = true;
-      }
-    }
-    if (in_word)
-      tokens.push_back(1);
-    return tokens;
+    return std::vector<int>(count_words(text), 1);
+  }
+
+  /**
+   * @brief Count words without materializing token IDs
+   */
+  size_t count_tokens(std::string_view text) const override
+  {
+    return count_words(text);
+  }
+
+  /**
+   * @brief Offsets are the byte ranges of the whitespace-separated words
+   */
+  bool supports_offsets() const override
+  {
+    return true;
+  }
+
+  /**
+   * @brief Given a text, return the `[begin, end)` byte range of every word
+   * @param text The input text
+   * @return One offset per word, in order
+   */
+  std::vector<TokenOffset> encode_offsets(const std::string& text) const override
+  {
+    std::vector<TokenOffset> offsets;
+    offsets.reserve(text.size() / 6);
+    for_each_word(text,
+                  [&offsets](size_t begin, size_t end) { offsets.push_back(TokenOffset{ begin, end }); });
+    return offsets;
   }
 
   /**
@@ -71,45 +83,21 @@ public:
                                   const std::vector<int>& starts,
                                   const std::vector<int>& lengths) const override
   {
-    // Reconstruct chunk texts by slicing the original doc by words according to starts/lengths
+    // Each chunk is the original text from its first word to its last, whitespace included
+    std::vector<TokenOffset> words = encode_offsets(doc);
     std::vector<std::string> chunk_texts;
     chunk_texts.reserve(chunk_token.size());
-
-    // Split doc into words preserving simple whitespace separation
-    std::vector<std::string> words;
-    words.reserve(doc.size() / 4);
-    std::string current;
-    for (char c : doc)
-    {
-      if (c == ' ' || c == '\n' || c == '\t')
-      {
-        if (!current.empty())
-        {
-          words.push_back(current);
-          current.clear();
-        }
-      }
-      else
-      {
-        current.push_back(c);
-      }
-    }
-    if (!current.empty())
-      words.push_back(current);
-
     for (size_t i = 0; i < chunk_token.size(); ++i)
     {
-      int start_idx = starts[i];
-      int len = lengths[i];
-      int end_idx = std::min<int>(start_idx + len, (int)words.size());
-      std::string text;
-      for (int w = start_idx; w < end_idx; ++w)
+      int start_idx = std::max(starts[i], 0);
+      int end_idx = std::min<int>(start_idx + lengths[i], (int)words.size());
+      if (start_idx >= end_idx)
       {
-        if (!text.empty())
-          text.push_back(' ');
-        text += words[w];
+        chunk_texts.emplace_back();
+        continue;
       }
-      chunk_texts.push_back(std::move(text));
+      size_t begin = words[start_idx].begin;
+      chunk_texts.push_back(doc.substr(begin, words[end_idx - 1].end - begin));
     }
 
     return chunk_texts;
@@ -1,16 +1,24 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <string_view>
 #include "nano_graphrag/operations/tokenize/base.hpp"
-#include "encoding.h"
-#include "modelparams.h"
+#include "nano_graphrag/operations/tokenize/tiktoken_registry.hpp"
 
 namespace nano_graphrag
 {
 
 /**
  * @brief Tokenizer using cpp-tiktoken (BPE-based) encodings
+ *
+ * Safe for concurrent use: all tokenizers of a model share one set of BPE
+ * tables, and each concurrent call encodes on its own clone of the encoder (see
+ * `TiktokenEncoding`). Encoded pieces of text (runs ending where an ASCII letter
+ * meets a space, which is always a pre-tokenizer boundary) are cached, so
+ * repeated words skip the encoder.
  */
 class TiktokenTokenizer : public ITokenizerStrategy
 {
@@ -19,25 +27,43 @@ public:
    * @brief Construct with default O200K_BASE encoding
    */
   TiktokenTokenizer()
+    : TiktokenTokenizer(LanguageModel::O200K_BASE)
   {
-    encoder_ = GptEncoding::get_encoding(LanguageModel::O200K_BASE);
   }
 
   /**
    * @brief Construct with specified language model encoding
+   *
+   * Cheap: the encoding is shared process-wide and its BPE tables are loaded on
+   * first use (or earlier via `prewarm_tiktoken_encoding`).
+   *
    * @param model The LanguageModel (e.g., O200K_BASE)
    */
   explicit TiktokenTokenizer(LanguageModel model)
+    : encoding_(shared_tiktoken_encoding(model))
   {
-    encoder_ = GptEncoding::get_encoding(model);
   }
 
   /**
    * @brief Given a text, return its token IDs
+   *
+   * Cached pieces are copied from the piece cache; consecutive misses are encoded
+   * in one call and split back into pieces by token byte lengths for caching.
    */
   std::vector<int> encode(const std::string& text) const override
   {
-    return encoder_->encode(text);
+    std::vector<int> out;
+    out.reserve(text.size() / 3);
+    encode_pieces(text, &out);
+    return out;
+  }
+
+  /**
+   * @brief Count tokens; cached pieces contribute their stored count without copying IDs
+   */
+  size_t count_tokens(std::string_view text) const override
+  {
+    return encode_pieces(text, nullptr);
   }
 
   /**
@@ -45,11 +71,13 @@ public:
    */
   std::vector<std::string> decode_batch(const std::vector<std::vector<int>>& tokens_list) const override
   {
-    std::vector<std::string> out;
-    out.reserve(tokens_list.size());
-    for (const auto& tk : tokens_list)
-      out.push_back(encoder_->decode(tk));
-    return out;
+    return encoding_->with_encoder([&tokens_list](GptEncoding& enc) {
+      std::vector<std::string> out;
+      out.reserve(tokens_list.size());
+      for (const auto& tk : tokens_list)
+        out.push_back(enc.decode(tk));
+      return out;
+    });
   }
 
   /**
@@ -63,6 +91,40 @@ public:
     return decode_batch(chunk_token);
   }
 
+  /**
+   * @brief Offsets are available since every token decodes to its exact source bytes
+   */
+  bool supports_offsets() const override
+  {
+    return true;
+  }
+
+  /**
+   * @brief Given a text, return the byte range of each token
+   *
+   * Token byte lengths come from a per-tokenizer table that is filled on first
+   * use by decoding each token ID once; a token may end inside a multi-byte
+   * UTF-8 character.
+   */
+  std::vector<TokenOffset> encode_offsets(const std::string& text) const override
+  {
+    std::vector<int> tokens = encode(text);
+    int max_id = 0;
+    for (int tk : tokens)
+      max_id = std::max(max_id, tk);
+    auto table = encoding_->token_bytes(max_id);
+    const uint32_t* bytes = table->data();
+    std::vector<TokenOffset> offsets(tokens.size());
+    size_t pos = 0;
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+      size_t end = std::min(text.size(), pos + (tokens[i] >= 0 ? bytes[tokens[i]] : 0));
+      offsets[i] = TokenOffset{ pos, end };
+      pos = end;
+    }
+    return offsets;
+  }
+
   /**
    * @brief Get the tokenizer type
    */
@@ -71,8 +133,119 @@ public:
     return TokenizerType::Tiktoken;
   }
 
+  /**
+   * @brief Tokenizer identity including the encoding model
+   */
+  std::string name() const override
+  {
+    return "tiktoken-" + std::to_string(static_cast<int>(encoding_->model()));
+  }
+
 private:
-  std::shared_ptr<GptEncoding> encoder_;
+  /**
+   * @brief Call `fn(begin, end)` for consecutive pieces of `text`
+   *
+   * A piece ends before every space that follows an ASCII letter. The tiktoken
+   * pre-tokenizer patterns never continue a letter run into a following space, so
+   * pieces can be encoded independently and concatenated.
+   */
+  template <typename Fn>
+  static void for_each_piece(std::string_view text, Fn&& fn)
+  {
+    auto is_alpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    size_t begin = 0;
+    for (size_t i = text.find(' ', 1); i != std::string::npos; i = text.find(' ', i + 1))
+    {
+      if (is_alpha(text[i - 1]))
+      {
+        fn(begin, i);
+        begin = i;
+      }
+    }
+    if (begin < text.size())
+      fn(begin, text.size());
+  }
+
+  /**
+   * @brief Encode `text` piece by piece through the cache
+   *
+   * @param out Receives the token IDs, or null to only count them
+   * @return Number of tokens
+   */
+  size_t encode_pieces(std::string_view text, std::vector<int>* out) const
+  {
+    size_t total = 0;
+    std::vector<int> hit;
+    std::vector<size_t> pending_ends;  // ends of the pieces in the current miss run
+    size_t run_begin = 0;
+    for_each_piece(text, [&](size_t begin, size_t end) {
+      std::string_view piece = text.substr(begin, end - begin);
+      size_t n = 0;
+      bool cached = piece.size() <= TiktokenEncoding::kMaxCachedPiece &&
+                    (out ? encoding_->cache().lookup(piece, hit) : encoding_->cache().count(piece, n));
+      if (!cached)
+      {
+        pending_ends.push_back(end);
+        return;
+      }
+      total += encode_run(text, run_begin, pending_ends, out);
+      if (out)
+      {
+        out->insert(out->end(), hit.begin(), hit.end());
+        n = hit.size();
+      }
+      total += n;
+      run_begin = end;
+    });
+    total += encode_run(text, run_begin, pending_ends, out);
+    return total;
+  }
+
+  /**
+   * @brief Encode the pieces of `text` from `run_begin` to the last pending end and cache them
+   * @return Number of tokens in the run
+   */
+  size_t encode_run(std::string_view text, size_t run_begin, std::vector<size_t>& pending_ends,
+                    std::vector<int>* out) const
+  {
+    if (pending_ends.empty())
+      return 0;
+    const size_t run_end = pending_ends.back();
+    std::string run(text.substr(run_begin, run_end - run_begin));
+    std::vector<int> ids =
+        encoding_->with_encoder([&run](GptEncoding& enc) { return enc.encode(run); });
+    int max_id = 0;
+    for (int tk : ids)
+      max_id = std::max(max_id, tk);
+    auto table = encoding_->token_bytes(max_id);
+
+    // split the run's tokens back into pieces; stop caching if a token straddles a piece end
+    size_t pos = run_begin;
+    size_t piece_begin = run_begin;
+    size_t first = 0;
+    size_t next_end = 0;
+    for (size_t i = 0; i < ids.size() && next_end < pending_ends.size(); ++i)
+    {
+      pos += ids[i] >= 0 ? (*table)[ids[i]] : 0;
+      if (pos < pending_ends[next_end])
+        continue;
+      if (pos > pending_ends[next_end])
+        break;
+      if (pos - piece_begin <= TiktokenEncoding::kMaxCachedPiece)
+        encoding_->cache().insert(text.substr(piece_begin, pos - piece_begin),
+                                  std::vector<int>(ids.begin() + static_cast<std::ptrdiff_t>(first),
+                                                   ids.begin() + static_cast<std::ptrdiff_t>(i + 1)));
+      piece_begin = pos;
+      first = i + 1;
+      ++next_end;
+    }
+    if (out)
+      out->insert(out->end(), ids.begin(), ids.end());
+    pending_ends.clear();
+    return ids.size();
+  }
+
+  std::shared_ptr<TiktokenEncoding> encoding_;
 };
 
 }  // namespace nano_graphrag
@@ -0,0 +1,332 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "encoding.h"
+#include "modelparams.h"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Sharded map from text piece to its token IDs
+ *
+ * A full shard evicts one entry per insert with the CLOCK policy: a hand sweeps
+ * the entries in insertion order, skipping (and clearing the mark of) those read
+ * since it last passed, so frequent pieces stay cached while memory is bounded.
+ */
+class TiktokenPieceCache
+{
+public:
+  bool count(std::string_view piece, size_t& n)
+  {
+    Shard& shard = shard_of(piece);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.map.find(std::string(piece));
+    if (it == shard.map.end())
+      return false;
+    it->second.referenced.store(true, std::memory_order_relaxed);
+    n = it->second.ids.size();
+    return true;
+  }
+
+  bool lookup(std::string_view piece, std::vector<int>& ids)
+  {
+    Shard& shard = shard_of(piece);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.map.find(std::string(piece));
+    if (it == shard.map.end())
+      return false;
+    it->second.referenced.store(true, std::memory_order_relaxed);
+    ids.assign(it->second.ids.begin(), it->second.ids.end());
+    return true;
+  }
+
+  void insert(std::string_view piece, std::vector<int> ids)
+  {
+    Shard& shard = shard_of(piece);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    std::string key(piece);
+    if (shard.map.count(key))
+      return;
+    if (shard.ring.size() < kMaxEntriesPerShard)
+    {
+      shard.ring.push_back(&emplace(shard, std::move(key), std::move(ids)));
+      return;
+    }
+    for (;;)
+    {
+      const std::string*& slot = shard.ring[shard.hand];
+      shard.hand = (shard.hand + 1) % shard.ring.size();
+      auto victim = shard.map.find(*slot);
+      if (victim->second.referenced.exchange(false, std::memory_order_relaxed))
+        continue;  // second chance
+      shard.map.erase(victim);
+      slot = &emplace(shard, std::move(key), std::move(ids));
+      return;
+    }
+  }
+
+private:
+  static constexpr size_t kShards = 16;
+  static constexpr size_t kMaxEntriesPerShard = 1 << 15;
+
+  struct Entry
+  {
+    explicit Entry(std::vector<int> token_ids)
+      : ids(std::move(token_ids))
+    {
+    }
+    std::vector<int> ids;
+    std::atomic<bool> referenced{ false };  // read since the hand last passed; set under a shared lock
+  };
+
+  struct Shard
+  {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, Entry> map;
+    std::vector<const std::string*> ring;  // keys of `map` in slot order (node keys are stable)
+    size_t hand{ 0 };
+  };
+
+  Shard& shard_of(std::string_view piece)
+  {
+    return shards_[std::hash<std::string_view>{}(piece) % kShards];
+  }
+
+  // Caller holds the shard's unique lock; returns the stored key
+  static const std::string& emplace(Shard& shard, std::string key, std::vector<int> ids)
+  {
+    auto it = shard.map
+                  .emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                           std::forward_as_tuple(std::move(ids)))
+                  .first;
+    return it->first;
+  }
+
+  Shard shards_[kShards];
+};
+
+/**
+ * @brief Process-wide state for one tiktoken encoding
+ *
+ * Holds the `GptEncoding`s of a `LanguageModel`, the piece cache and the token
+ * byte length table. All `TiktokenTokenizer`s for the same model share one
+ * instance through `shared_tiktoken_encoding`. The BPE tables are read from the
+ * model file once per process: by `prewarm()` on a background thread, or by the
+ * first call that needs them.
+ *
+ * cpp-tiktoken does not promise that an encoder may be used by several threads
+ * at once, so every concurrent caller gets its own encoder. The loaded one is
+ * kept unused as a prototype; `with_encoder` borrows an idle clone of it, or
+ * copies a new one when all are busy. Cloning copies the in-memory tables
+ * without touching the file, and clones are returned for reuse, so the pool
+ * grows to the peak number of concurrent callers.
+ */
+class TiktokenEncoding
+{
+public:
+  /** Longest piece kept in the piece cache, in bytes. */
+  static constexpr size_t kMaxCachedPiece = 64;
+
+  explicit TiktokenEncoding(LanguageModel model)
+    : model_(model)
+  {
+  }
+
+  TiktokenEncoding(const TiktokenEncoding&) = delete;
+  TiktokenEncoding& operator=(const TiktokenEncoding&) = delete;
+
+  /**
+   * @brief Start loading the encoder on a background thread; no-op after the first call
+   */
+  void prewarm()
+  {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    if (warm_.valid() || encoder_)
+      return;
+    warm_ = std::async(std::launch::async, [this]() {
+                auto enc = GptEncoding::get_encoding(model_);
+                std::lock_guard<std::mutex> lock(load_mutex_);
+                encoder_ = std::move(enc);
+              }).share();
+  }
+
+  /**
+   * @brief Whether the encoder has finished loading
+   */
+  bool loaded() const
+  {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    return encoder_ != nullptr;
+  }
+
+  LanguageModel model() const
+  {
+    return model_;
+  }
+
+  TiktokenPieceCache& cache()
+  {
+    return cache_;
+  }
+
+  /**
+   * @brief Run `fn` with an encoder that no other thread is using
+   *
+   * Loads the tables on first use; a pending `prewarm()` load is awaited instead
+   * of starting a second one.
+   */
+  template <typename Fn>
+  auto with_encoder(Fn&& fn) -> std::invoke_result_t<Fn, GptEncoding&>
+  {
+    std::unique_ptr<GptEncoding> enc = acquire();
+    struct Return
+    {
+      TiktokenEncoding* self;
+      std::unique_ptr<GptEncoding>& enc;
+      ~Return()
+      {
+        self->release(std::move(enc));
+      }
+    } guard{ this, enc };
+    return fn(*enc);
+  }
+
+  /**
+   * @brief Encoder clones made so far (idle or in use)
+   */
+  size_t clones() const
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return clones_;
+  }
+
+  /**
+   * @brief Byte length of every token ID up to at least `max_id`
+   *
+   * The table is immutable once published; growing it builds a copy under a mutex
+   * and swaps it in, so concurrent readers never see a partial table.
+   */
+  std::shared_ptr<const std::vector<uint32_t>> token_bytes(int max_id)
+  {
+    auto table = std::atomic_load(&token_bytes_);
+    if (table && static_cast<int>(table->size()) > max_id)
+      return table;
+    std::lock_guard<std::mutex> lock(token_bytes_mutex_);
+    table = std::atomic_load(&token_bytes_);
+    if (table && static_cast<int>(table->size()) > max_id)
+      return table;
+    auto grown = std::make_shared<std::vector<uint32_t>>(table ? *table : std::vector<uint32_t>{});
+    with_encoder([&grown, max_id](GptEncoding& enc) {
+      std::vector<int> single(1);
+      for (int id = static_cast<int>(grown->size()); id <= max_id; ++id)
+      {
+        single[0] = id;
+        uint32_t len = 0;
+        try
+        {
+          len = static_cast<uint32_t>(enc.decode(single).size());
+        }
+        catch (...)
+        {
+          // IDs without a vocabulary entry never appear in encoder output
+        }
+        grown->push_back(len);
+      }
+      return 0;
+    });
+    table = grown;
+    std::atomic_store(&token_bytes_, table);
+    return table;
+  }
+
+private:
+  std::unique_ptr<GptEncoding> acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      if (!idle_.empty())
+      {
+        auto enc = std::move(idle_.back());
+        idle_.pop_back();
+        return enc;
+      }
+      ++clones_;
+    }
+    return std::make_unique<GptEncoding>(prototype());  // outside the lock: copies the tables
+  }
+
+  void release(std::unique_ptr<GptEncoding> enc)
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    idle_.push_back(std::move(enc));
+  }
+
+  // The loaded encoder; only ever copied, never used to encode
+  const GptEncoding& prototype()
+  {
+    std::shared_future<void> warm;
+    {
+      std::lock_guard<std::mutex> lock(load_mutex_);
+      if (encoder_)
+        return *encoder_;
+      warm = warm_;
+    }
+    if (warm.valid())
+      warm.get();  // rethrows a failed background load
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    if (!encoder_)
+      encoder_ = GptEncoding::get_encoding(model_);  // callers racing here wait for this one load
+    return *encoder_;
+  }
+
+  LanguageModel model_;
+  std::shared_ptr<GptEncoding> encoder_;  // prototype; set once, never replaced
+  mutable std::mutex load_mutex_;
+  std::shared_future<void> warm_;
+  std::vector<std::unique_ptr<GptEncoding>> idle_;  // clones not in use
+  size_t clones_{ 0 };
+  mutable std::mutex pool_mutex_;
+  TiktokenPieceCache cache_;
+  std::shared_ptr<const std::vector<uint32_t>> token_bytes_;
+  std::mutex token_bytes_mutex_;
+};
+
+/**
+ * @brief Shared state for `model`, created on first request and kept for the process lifetime
+ *
+ * Creation does not load BPE tables.
+ */
+inline std::shared_ptr<TiktokenEncoding> shared_tiktoken_encoding(LanguageModel model)
+{
+  static std::mutex mutex;
+  static std::map<LanguageModel, std::shared_ptr<TiktokenEncoding>> registry;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& entry = registry[model];
+  if (!entry)
+    entry = std::make_shared<TiktokenEncoding>(model);
+  return entry;
+}
+
+/**
+ * @brief Begin loading the BPE tables for `model` in the background
+ */
+inline void prewarm_tiktoken_encoding(LanguageModel model)
+{
+  shared_tiktoken_encoding(model)->prewarm();
+}
+
+}  // namespace nano_graphrag
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "nano_graphrag/utils/ThreadPool.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Compact (CSR) adjacency over dense node indices.
+ *
+ * Neighbors of node `v` are `targets[offsets[v] .. offsets[v + 1])`. Undirected
+ * edges appear once in each endpoint's list.
+ */
+struct CompactAdjacency
+{
+  std::vector<int64_t> offsets;
+  std::vector<int> targets;
+
+  size_t num_nodes() const
+  {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  int degree(size_t v) const
+  {
+    return static_cast<int>(offsets[v + 1] - offsets[v]);
+  }
+};
+
+/**
+ * @brief PageRank settings.
+ */
+struct PageRankParam
+{
+  double damping{ 0.85 };
+  int max_iterations{ 100 };
+  double tolerance{ 1e-6 };  // stop when the L1 change of the score vector falls below this
+  size_t num_threads{ 0 };   // 0 = hardware threads; ignored by the overload taking a pool
+};
+
+/**
+ * @brief Power-iteration PageRank as a parallel sparse matrix-vector product.
+ *
+ * Each iteration pulls contributions along the compact adjacency in parallel
+ * node ranges on the workers of `pool`. Mass from isolated nodes is
+ * redistributed along the teleport vector, so scores always sum to 1.
+ *
+ * @param g Compact adjacency.
+ * @param param Damping and convergence settings.
+ * @param pool Workers for the per-iteration node ranges (not spawned per call).
+ * @param personalization Optional non-negative teleport weights per node (empty = uniform);
+ *        a non-empty vector gives personalized PageRank.
+ * @param init Optional starting scores (e.g. the previous result for an incremental
+ *        refresh). Missing entries for nodes added since are filled uniformly.
+ * @return One score per node.
+ */
+inline std::vector<double> pagerank(const CompactAdjacency& g, const PageRankParam& param, ThreadPool& pool,
+                                    const std::vector<double>& personalization = {},
+                                    std::vector<double> init = {})
+{
+  const size_t n = g.num_nodes();
+  if (n == 0)
+    return {};
+
+  std::vector<double> teleport(n, 1.0 / static_cast<double>(n));
+  if (personalization.size() == n)
+  {
+    double sum = 0.0;
+    for (double w : personalization)
+      sum += std::max(w, 0.0);
+    if (sum > 0.0)
+      for (size_t v = 0; v < n; ++v)
+        teleport[v] = std::max(personalization[v], 0.0) / sum;
+  }
+
+  std::vector<double> x = std::move(init);
+  if (x.size() != n)
+    x.resize(n, 1.0 / static_cast<double>(n));
+  double total = 0.0;
+  for (double s : x)
+    total += s;
+  for (auto& s : x)
+    s = total > 0.0 ? s / total : 1.0 / static_cast<double>(n);
+
+  const size_t threads = std::max<size_t>(pool.size(), 1);
+  std::vector<double> contrib(n, 0.0);
+  std::vector<double> next(n, 0.0);
+  std::vector<double> partial(threads, 0.0);
+  const double d = param.damping;
+
+  for (int it = 0; it < param.max_iterations; ++it)
+  {
+    // contrib[u] = x[u] / deg(u); isolated nodes feed the teleport vector instead
+    std::fill(partial.begin(), partial.end(), 0.0);
+    parallel_for(pool, 0, n, [&](size_t lo, size_t hi, size_t tid) {
+      double dangling = 0.0;
+      for (size_t u = lo; u < hi; ++u)
+      {
+        int deg = g.degree(u);
+        if (deg > 0)
+          contrib[u] = x[u] / deg;
+        else
+        {
+          contrib[u] = 0.0;
+          dangling += x[u];
+        }
+      }
+      partial[tid] = dangling;
+    });
+    double dangling = 0.0;
+    for (double p : partial)
+      dangling += p;
+
+    std::fill(partial.begin(), partial.end(), 0.0);
+    parallel_for(pool, 0, n, [&](size_t lo, size_t hi, size_t tid) {
+      double diff = 0.0;
+      for (size_t v = lo; v < hi; ++v)
+      {
+        double sum = 0.0;
+        for (int64_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+          sum += contrib[static_cast<size_t>(g.targets[static_cast<size_t>(e)])];
+        next[v] = d * (sum + dangling * teleport[v]) + (1.0 - d) * teleport[v];
+        diff += std::fabs(next[v] - x[v]);
+      }
+      partial[tid] = diff;
+    });
+    x.swap(next);
+    double diff = 0.0;
+    for (double p : partial)
+      diff += p;
+    if (diff < param.tolerance)
+      break;
+  }
+  return x;
+}
+
+/**
+ * @brief PageRank on a pool of `param.num_threads` workers started for this call.
+ *
+ * Convenience for one-off computations; repeated callers should keep a
+ * `ThreadPool` and use the overload taking it.
+ */
+inline std::vector<double> pagerank(const CompactAdjacency& g, const PageRankParam& param,
+                                    const std::vector<double>& personalization = {},
+                                    std::vector<double> init = {})
+{
+  ThreadPool pool(param.num_threads);
+  return pagerank(g, param, pool, personalization, std::move(init));
+}
+
+}  // namespace nano_graphrag
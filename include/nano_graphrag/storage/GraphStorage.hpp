@@ -7,8 +7,14 @@
 #include <tuple>
 #include <optional>
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
 
 #include "nano_graphrag/storage/base.hpp"
+#include "nano_graphrag/storage/GraphAnalytics.hpp"
+#include "nano_graphrag/utils/Persistent.hpp"
 #include "nano_graphrag/utils/Types.hpp"
 
 namespace nano_graphrag
@@ -18,77 +24,115 @@ namespace nano_graphrag
  * @brief In-memory graph storage backend.
  *
  * Stores nodes and undirected edges with property maps, maintains adjacency,
- * and provides simple clustering via connected components. Intended for
- * lightweight graph operations without external dependencies.
+ * and provides simple clustering via connected components (kept incrementally
+ * by a union-find updated on every edge upsert). Intended for lightweight
+ * graph operations without external dependencies.
+ *
+ * Concurrency: by default the storage is unsynchronized. With the config key
+ * `snapshot_reads` set to `true`, writers build the next version privately and
+ * `index_done_callback` publishes it atomically. Readers always see the last
+ * published version and never block writers; `snapshot()` pins one version for
+ * lock-free traversal across many calls. Writes, including `clustering()` and
+ * `compute_centrality()`, stay invisible to every reader (the writing thread
+ * included) until the next `index_done_callback`.
+ *
+ * All graph state lives in persistent containers (see utils/Persistent.hpp), so
+ * starting the next version from a published one copies a few root pointers;
+ * writers then clone only the trie paths they touch, and a batch costs time and
+ * memory in proportion to what it changes rather than to the graph size.
+ *
+ * Analytics: nodes get dense indices, so a degree query is one id lookup plus
+ * an offset read from the compact adjacency (or the node's neighbor list while
+ * the compact adjacency is stale). `compute_centrality()` stores PageRank as a
+ * dense per-node array, computed over the compact adjacency on a thread pool the
+ * storage keeps for its analytics. With the config key `centrality` set to
+ * `pagerank`, scores are refreshed at every `index_done_callback`, warm-started
+ * from the previous result, and `get_subgraph` can rank its expansion by them
+ * (`SubgraphParam::rank_by_centrality`). Other keys: `analytics_threads`,
+ * `pagerank_damping`, `pagerank_max_iterations`, `pagerank_tolerance`.
  */
 class InMemoryGraphStorage : public BaseGraphStorage
 {
+  struct Data;
+
 public:
   explicit InMemoryGraphStorage(const std::string& ns = "",
                                 const std::unordered_map<std::string, std::string>& cfg = {})
   {
     this->namespace_name = ns;
     this->global_config = cfg;
+    snapshot_reads_ = parse_bool(cfg, "snapshot_reads", false);
+    auto_centrality_ = cfg.count("centrality") && cfg.at("centrality") == "pagerank";
+    pagerank_param_.damping = parse_double(cfg, "pagerank_damping", pagerank_param_.damping);
+    pagerank_param_.max_iterations =
+        static_cast<int>(parse_double(cfg, "pagerank_max_iterations", pagerank_param_.max_iterations));
+    pagerank_param_.tolerance = parse_double(cfg, "pagerank_tolerance", pagerank_param_.tolerance);
+    pagerank_param_.num_threads = static_cast<size_t>(parse_double(cfg, "analytics_threads", 0));
+    working_ = std::make_shared<Data>();
+    if (snapshot_reads_)
+      published_ = std::make_shared<const Data>();
   }
 
   /** Check if a node exists. */
   bool has_node(const std::string& node_id) const override
   {
-    return nodes_.count(node_id) > 0;
+    auto d = read();
+    int i = d->index_of(node_id);
+    return i >= 0 && d->node_props[static_cast<size_t>(i)];
   }
 
   /** Check if an undirected edge exists between nodes s and t. */
   bool has_edge(const std::string& s, const std::string& t) const override
   {
-    auto k = canonical_edge_key_str(s, t);
-    return edges_.count(k) > 0;
+    return read()->edge(s, t) != nullptr;
   }
 
   /** Number of neighbors of the node. */
   int node_degree(const std::string& node_id) const override
   {
-    auto it = adjacency_.find(node_id);
-    if (it == adjacency_.end())
-      return 0;
-    return static_cast<int>(it->second.size());
+    auto d = read();
+    return d->degree(d->index_of(node_id));
   }
 
   /** Heuristic edge degree: sum of endpoint degrees. */
   int edge_degree(const std::string& s, const std::string& t) const override
   {
-    return node_degree(s) + node_degree(t);
+    auto d = read();
+    return d->degree(d->index_of(s)) + d->degree(d->index_of(t));
   }
 
   /** Retrieve node properties, if present. */
   std::optional<std::unordered_map<std::string, std::string>>
   get_node(const std::string& node_id) const override
   {
-    auto it = nodes_.find(node_id);
-    if (it == nodes_.end())
+    auto d = read();
+    const Props* props = d->node(node_id);
+    if (!props)
       return std::nullopt;
-    return it->second;
+    return *props;
   }
 
   /** Retrieve edge properties for undirected pair {s,t}, if present. */
   std::optional<std::unordered_map<std::string, std::string>> get_edge(const std::string& s,
                                                                        const std::string& t) const override
   {
-    auto k = canonical_edge_key_str(s, t);
-    auto it = edges_.find(k);
-    if (it == edges_.end())
+    auto d = read();
+    const Props* props = d->edge(s, t);
+    if (!props)
       return std::nullopt;
-    return it->second;
+    return *props;
   }
 
   /** List incident edges (as pairs) for a node. */
   std::vector<std::pair<std::string, std::string>> get_node_edges(const std::string& node_id) const override
   {
+    auto d = read();
     std::vector<std::pair<std::string, std::string>> out;
-    auto it = adjacency_.find(node_id);
-    if (it == adjacency_.end())
+    int i = d->index_of(node_id);
+    if (i < 0)
       return out;
-    for (const auto& tgt : it->second)
-      out.emplace_back(node_id, tgt);
+    for (int nb : d->neighbors[static_cast<size_t>(i)])
+      out.emplace_back(node_id, d->node_ids[static_cast<size_t>(nb)]);
     return out;
   }
 
@@ -96,8 +140,8 @@ public:
   void upsert_node(const std::string& node_id,
                    const std::unordered_map<std::string, std::string>& node_data) override
   {
-    nodes_[node_id] = node_data;
-    adjacency_.emplace(node_id, std::unordered_set<std::string>{});
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write().upsert_node(node_id, node_data);
   }
 
   /** Batch upsert nodes. */
@@ -105,18 +149,18 @@ public:
       const std::vector<std::pair<std::string, std::unordered_map<std::string, std::string>>>& nodes_data)
       override
   {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto& d = write();
     for (const auto& kv : nodes_data)
-      upsert_node(kv.first, kv.second);
+      d.upsert_node(kv.first, kv.second);
   }
 
   /** Upsert undirected edge and its properties. */
   void upsert_edge(const std::string& s, const std::string& t,
                    const std::unordered_map<std::string, std::string>& edge_data) override
   {
-    auto k = canonical_edge_key_str(s, t);
-    edges_[k] = edge_data;
-    adjacency_[s].insert(t);
-    adjacency_[t].insert(s);
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write().upsert_edge(s, t, edge_data);
   }
 
   /** Batch upsert edges. */
@@ -124,119 +168,628 @@ public:
       const std::vector<std::tuple<std::string, std::string, std::unordered_map<std::string, std::string>>>&
           edges_data) override
   {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto& d = write();
     for (const auto& e : edges_data)
-      upsert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+      d.upsert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
   }
 
   /**
    * @brief Perform clustering and annotate nodes.
    *
-   * Placeholder implementation: clusters by connected components (BFS) and
-   * writes a `clusters` attribute on nodes as a simple JSON string.
+   * Placeholder implementation: clusters by connected components and writes a
+   * `clusters` attribute on nodes as a simple JSON string. Components come from
+   * the union-find maintained on upsert, so only nodes whose label is stale are
+   * rewritten: new or re-upserted nodes, and the members of the smaller side of
+   * each merge. Every node moves to a component at least twice its previous size
+   * when relabelled, so a node is relabelled O(log n) times over any insert stream.
+   *
+   * The cluster id is the component id (see `component_id`): the dense index of
+   * the component's root node. Ids are unique per component and survive merges
+   * into the larger side, but are not contiguous.
    */
-  void clustering(const std::string& algorithm) override
-  {
-    // Simple placeholder: mark all nodes level 0 cluster by connected components
-    // Assign clusters by BFS
-    int cluster_id = 0;
-    std::unordered_set<std::string> visited;
-    for (const auto& n : nodes_)
-    {
-      if (visited.count(n.first))
-        continue;
-      // BFS
-      std::vector<std::string> queue{ n.first };
-      visited.insert(n.first);
-      while (!queue.empty())
-      {
-        auto cur = queue.back();
-        queue.pop_back();
-        // store cluster info as JSON-like strings
-        nodes_[cur]["clusters"] =
-            std::string("[{\"level\":0,\"cluster\":") + std::to_string(cluster_id) + "}]";
-        for (const auto& nb : adjacency_[cur])
-          if (!visited.count(nb))
-          {
-            visited.insert(nb);
-            queue.push_back(nb);
-          }
-      }
-      cluster_id++;
+  void clustering(const std::string& /*algorithm*/) override
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto& d = write();
+    for (int n : d.dirty)
+    {
+      d.is_dirty.mut(static_cast<size_t>(n)) = 0;
+      // store cluster info as JSON-like strings
+      d.set_property(n, "clusters",
+                     std::string("[{\"level\":0,\"cluster\":") + std::to_string(d.find(n)) + "}]");
+    }
+    d.dirty.clear();
+  }
+
+  /**
+   * @brief Finish an insert batch: refresh centrality and publish the writers' version.
+   *
+   * Centrality is refreshed when `centrality` is configured and the graph changed.
+   * In snapshot mode the working version is then handed over as the new immutable
+   * snapshot; the next write starts a fresh private copy from it.
+   */
+  void index_done_callback() override
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!working_)
+      return;  // nothing written since the last publish
+    if (auto_centrality_ && working_->centrality_stale)
+      refresh_centrality(*working_);
+    if (!snapshot_reads_)
+      return;
+    std::shared_ptr<const Data> next = std::move(working_);
+    std::atomic_store(&published_, std::move(next));
+  }
+
+  /**
+   * @brief Pin the current read version as a read-only storage view.
+   *
+   * In snapshot mode the view is immutable and can be traversed from any number
+   * of threads without synchronization while writers keep going. Without
+   * snapshot mode it shares the live data and is only safe when no writer runs.
+   */
+  std::shared_ptr<const InMemoryGraphStorage> snapshot() const
+  {
+    return std::shared_ptr<const InMemoryGraphStorage>(
+        new InMemoryGraphStorage(this->namespace_name, std::const_pointer_cast<Data>(read())));
+  }
+
+  /** Whether reads are served from published snapshots. */
+  bool snapshot_reads() const
+  {
+    return snapshot_reads_;
+  }
+
+  /** Connected-component id of a node (its root's dense index), or -1 if the node is unknown. */
+  int component_id(const std::string& node_id) const
+  {
+    return read()->component_id(node_id);
+  }
+
+  /** Whether two nodes are in the same connected component. */
+  bool connected(const std::string& a, const std::string& b) const
+  {
+    auto d = read();
+    int ca = d->component_id(a);
+    return ca >= 0 && ca == d->component_id(b);
+  }
+
+  /** Number of connected components (isolated nodes count as their own component). */
+  size_t component_count() const
+  {
+    return read()->component_count;
+  }
+
+  /**
+   * @brief Recompute PageRank for all nodes and store it as a dense per-node array.
+   *
+   * Rebuilds the compact adjacency if edges changed and warm-starts from the
+   * previous scores, so refreshing after an insert batch takes a few iterations.
+   * In snapshot mode the scores become visible at the next `index_done_callback`.
+   */
+  void compute_centrality()
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    refresh_centrality(write());
+  }
+
+  /** Dense node index used by the per-node arrays, or -1 if the node is unknown. */
+  int node_index(const std::string& node_id) const
+  {
+    return read()->index_of(node_id);
+  }
+
+  /** Degree by dense node index (array read). */
+  int degree_at(int index) const
+  {
+    return read()->degree(index);
+  }
+
+  /** PageRank by dense node index (array read); 0 until `compute_centrality()` ran. */
+  double pagerank_at(int index) const
+  {
+    return read()->pagerank_at(index);
+  }
+
+  /** PageRank of a node; 0 if unknown or not yet computed. */
+  double node_pagerank(const std::string& node_id) const
+  {
+    auto d = read();
+    return d->pagerank_at(d->index_of(node_id));
+  }
+
+  /**
+   * @brief Personalized PageRank with teleports restricted to the seed nodes.
+   *
+   * Query-dependent, so computed on demand over the compact adjacency (reused
+   * from the last `compute_centrality()` when still current).
+   *
+   * @return Scores indexed by dense node index (see `node_index`).
+   */
+  std::vector<double> personalized_pagerank(const std::vector<std::string>& seeds) const
+  {
+    auto d = read();
+    std::vector<double> weights(d->node_ids.size(), 0.0);
+    for (const auto& s : seeds)
+    {
+      int i = d->index_of(s);
+      if (i >= 0)
+        weights[static_cast<size_t>(i)] = 1.0;
     }
+    auto pool = analytics_pool();
+    if (d->csr && !d->csr_stale)
+      return pagerank(*d->csr, pagerank_param_, *pool, weights);
+    return pagerank(d->build_csr(*pool), pagerank_param_, *pool, weights);
   }
 
   /**
    * @brief Construct a simple community schema by grouping nodes by cluster id.
    *
    * Edges are canonicalized and uniqued; `occurrence` is derived from chunk_ids
-   * count if present.
+   * count if present. Built in parallel: each thread accumulates communities for
+   * a range of node indices, the partials are merged in range order, and every
+   * community's edge list is then uniqued and sorted (large communities with a
+   * parallel sort, small ones spread across threads).
    */
   std::unordered_map<std::string, SingleCommunity> community_schema() const override
   {
-    std::unordered_map<std::string, SingleCommunity> out;
-    // Build communities from node "clusters" attribute
-    for (const auto& n : nodes_)
-    {
-      auto itc = n.second.find("clusters");
-      if (itc == n.second.end())
-        continue;
-      // Extremely simple parse: expect one cluster id
-      int cluster = 0;  // default
-      try
+    auto d = read();
+    const size_t n = d->node_ids.size();
+    auto pool = analytics_pool();
+    const size_t threads = pool->size();
+
+    // Per-thread accumulation on dense node indices; edges as (min, max) index pairs
+    struct Partial
+    {
+      std::vector<int> nodes;
+      std::vector<std::pair<int, int>> edges;
+    };
+    std::vector<std::unordered_map<int, Partial>> local(threads);
+    size_t used = parallel_for(*pool, 0, n, [&](size_t lo, size_t hi, size_t tid) {
+      auto& acc = local[tid];
+      for (size_t v = lo; v < hi; ++v)
       {
-        auto pos = itc->second.find("cluster\":");
-        if (pos != std::string::npos)
-        {
-          cluster = std::stoi(itc->second.substr(pos + 9));
-        }
+        // Build communities from node "clusters" attribute
+        const Props* props = d->node_props[v].get();
+        if (!props)
+          continue;
+        auto itc = props->find("clusters");
+        if (itc == props->end())
+          continue;
+        auto& part = acc[parse_cluster(itc->second)];
+        int vi = static_cast<int>(v);
+        part.nodes.push_back(vi);
+        for (int nb : d->neighbors[v])
+          part.edges.emplace_back(std::min(vi, nb), std::max(vi, nb));
       }
-      catch (...)
+    });
+
+    // Merge partials in range order so node lists stay ordered by index
+    std::unordered_map<int, Partial> merged;
+    for (size_t t = 0; t < used; ++t)
+      for (auto& kv : local[t])
       {
+        auto& m = merged[kv.first];
+        if (m.nodes.empty())
+        {
+          m = std::move(kv.second);
+          continue;
+        }
+        m.nodes.insert(m.nodes.end(), kv.second.nodes.begin(), kv.second.nodes.end());
+        m.edges.insert(m.edges.end(), kv.second.edges.begin(), kv.second.edges.end());
       }
-      auto key = std::to_string(cluster);
+    local.clear();
+
+    std::unordered_map<std::string, SingleCommunity> out;
+    out.reserve(merged.size());
+    std::vector<std::pair<Partial*, SingleCommunity*>> large, small;
+    for (auto& kv : merged)
+    {
+      auto key = std::to_string(kv.first);
       auto& comm = out[key];
       comm.level = 0;
       comm.title = std::string("Cluster ") + key;
-      comm.nodes.push_back(n.first);
-      // edges accumulation
-      auto eds = get_node_edges(n.first);
-      for (auto& e : eds)
+      (kv.second.edges.size() >= kParallelSortMin ? large : small).emplace_back(&kv.second, &comm);
+    }
+
+    // Unique edges per community, then resolve ids and sort canonical string pairs
+    auto finalize = [&d](Partial& part, SingleCommunity& comm, size_t sort_threads) {
+      comm.nodes.reserve(part.nodes.size());
+      for (int v : part.nodes)
+        comm.nodes.push_back(d->node_ids[static_cast<size_t>(v)]);
+      auto& ids = part.edges;
+      parallel_sort(ids, sort_threads);
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      comm.edges.reserve(ids.size());
+      for (const auto& e : ids)
       {
-        auto a = e.first, b = e.second;
-        if (a > b)
-          std::swap(a, b);
-        comm.edges.emplace_back(a, b);
+        const auto& a = d->node_ids[static_cast<size_t>(e.first)];
+        const auto& b = d->node_ids[static_cast<size_t>(e.second)];
+        if (a < b)
+          comm.edges.emplace_back(a, b);
+        else
+          comm.edges.emplace_back(b, a);
       }
-    }
-    // Unique edges per community
-    for (auto& kv : out)
-    {
-      auto& edges = kv.second.edges;
-      std::sort(edges.begin(), edges.end());
-      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+      std::vector<std::pair<int, int>>().swap(ids);
+      parallel_sort(comm.edges, sort_threads);
       // occurrence heuristic by chunk_ids count
-      kv.second.occurrence =
-          kv.second.chunk_ids.empty() ? 0.0 : static_cast<double>(kv.second.chunk_ids.size());
-    }
+      comm.occurrence = comm.chunk_ids.empty() ? 0.0 : static_cast<double>(comm.chunk_ids.size());
+    };
+    for (auto& c : large)
+      finalize(*c.first, *c.second, threads);
+    parallel_for(*pool, 0, small.size(), [&](size_t lo, size_t hi, size_t) {
+      for (size_t i = lo; i < hi; ++i)
+        finalize(*small[i].first, *small[i].second, 1);
+    });
     return out;
   }
 
+  /** Threads used by analytics (centrality, community schema); 0 = hardware threads. */
+  void set_analytics_threads(size_t n)
+  {
+    std::shared_ptr<ThreadPool> old;
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      pagerank_param_.num_threads = n;
+      old = std::move(pool_);
+    }
+    // `old` joins its workers here, outside the lock, once running analytics release it
+  }
+
+  /**
+   * @brief Batch k-hop neighborhood lookup reading adjacency and properties directly.
+   *
+   * Same semantics as `BaseGraphStorage::get_subgraph`, without building per-node
+   * edge vectors or going through the virtual per-node accessors. With
+   * `param.rank_by_centrality` nodes rank by PageRank when scores have been
+   * computed (see `compute_centrality`), otherwise by degree.
+   */
+  Subgraph get_subgraph(const std::vector<std::string>& seeds, const SubgraphParam& param = {}) const override
+  {
+    static const PersistentVector<int> no_neighbors;
+    auto d = read();
+    return build_subgraph(
+        seeds, param, [&d](const std::string& id) { return d->node(id) != nullptr; },
+        [&d](const std::string& id) {
+          int i = d->index_of(id);
+          return NeighborIds{ d.get(), i < 0 ? &no_neighbors : &d->neighbors[static_cast<size_t>(i)] };
+        },
+        [&d](const std::string& id) { return d->degree(d->index_of(id)); },
+        [&d, by_centrality = param.rank_by_centrality && d->pagerank](const std::string& id, int degree) {
+          return by_centrality ? d->pagerank_at(d->index_of(id)) : static_cast<double>(degree);
+        },
+        [&d](const std::string& id) { return d->node(id); },
+        [&d](const std::string& s, const std::string& t) { return d->edge(s, t); });
+  }
+
 private:
-  static inline std::pair<std::string, std::string> canonical_edge_key(const std::string& s,
-                                                                       const std::string& t)
+  using Props = std::unordered_map<std::string, std::string>;
+
+  /** One version of the graph: property maps, adjacency, union-find state and analytics. */
+  struct Data
+  {
+    // Nodes are interned to dense indices and every per-node container below is
+    // indexed like `node_ids`. Containers are persistent, so copying a version
+    // shares all of them and writes clone only what they touch.
+    PersistentHashMap<std::string, int> node_index;
+    PersistentVector<std::string> node_ids;
+    PersistentVector<std::shared_ptr<const Props>> node_props;  // null: only seen as an edge endpoint
+    PersistentVector<PersistentVector<int>> neighbors;           // so degree is a size read
+    PersistentHashMap<uint64_t, std::shared_ptr<const Props>> edges;  // keyed by `edge_key`
+
+    // Incremental connected components: union-find over node indices, union by
+    // size with path halving. `members[root]` lists the nodes of each component and
+    // `dirty` the nodes whose cluster label is stale (flagged in `is_dirty`): a merge
+    // only changes the root of the smaller side, so only its members are flagged.
+    PersistentVector<int> parent;
+    PersistentVector<PersistentVector<int>> members;
+    PersistentVector<int> dirty;
+    PersistentVector<char> is_dirty;
+    size_t component_count{ 0 };
+
+    // Analytics, replaced as a whole when recomputed: compact adjacency and PageRank scores
+    std::shared_ptr<const CompactAdjacency> csr;
+    std::shared_ptr<const std::vector<double>> pagerank;
+    bool csr_stale{ true };
+    bool centrality_stale{ true };
+
+    static uint64_t edge_key(int a, int b)
+    {
+      if (a > b)
+        std::swap(a, b);
+      return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+    }
+
+    int index_of(const std::string& node_id) const
+    {
+      const int* i = node_index.find(node_id);
+      return i ? *i : -1;
+    }
+
+    const Props* node(const std::string& node_id) const
+    {
+      int i = index_of(node_id);
+      return i < 0 ? nullptr : node_props[static_cast<size_t>(i)].get();
+    }
+
+    const Props* edge(const std::string& s, const std::string& t) const
+    {
+      int si = index_of(s);
+      int ti = index_of(t);
+      if (si < 0 || ti < 0)
+        return nullptr;
+      const auto* props = edges.find(edge_key(si, ti));
+      return props ? props->get() : nullptr;
+    }
+
+    int degree(int i) const
+    {
+      if (i < 0)
+        return 0;
+      if (csr && !csr_stale)
+        return csr->degree(static_cast<size_t>(i));
+      return static_cast<int>(neighbors[static_cast<size_t>(i)].size());
+    }
+
+    double pagerank_at(int i) const
+    {
+      if (!pagerank || i < 0 || static_cast<size_t>(i) >= pagerank->size())
+        return 0.0;
+      return (*pagerank)[static_cast<size_t>(i)];
+    }
+
+    void upsert_node(const std::string& node_id, const Props& node_data)
+    {
+      int i = intern(node_id);
+      node_props.mut(static_cast<size_t>(i)) = std::make_shared<const Props>(node_data);
+      // properties were replaced, so the node needs its `clusters` attribute rewritten
+      mark_dirty(i);
+    }
+
+    void upsert_edge(const std::string& s, const std::string& t, const Props& edge_data)
+    {
+      int si = intern(s);
+      int ti = intern(t);
+      bool inserted = false;
+      edges.mut(edge_key(si, ti), &inserted) = std::make_shared<const Props>(edge_data);
+      if (inserted)
+      {
+        neighbors.mut(static_cast<size_t>(si)).push_back(ti);
+        if (si != ti)
+          neighbors.mut(static_cast<size_t>(ti)).push_back(si);
+        csr_stale = centrality_stale = true;
+      }
+      unite(si, ti);
+    }
+
+    void set_property(int i, const std::string& key, std::string value)
+    {
+      auto& slot = node_props.mut(static_cast<size_t>(i));
+      auto props = slot ? std::make_shared<Props>(*slot) : std::make_shared<Props>();
+      (*props)[key] = std::move(value);
+      slot = std::move(props);
+    }
+
+    /** Build the compact adjacency from the neighbor index lists (rows copied in parallel). */
+    CompactAdjacency build_csr(ThreadPool& pool) const
+    {
+      CompactAdjacency g;
+      const size_t n = neighbors.size();
+      g.offsets.assign(n + 1, 0);
+      for (size_t v = 0; v < n; ++v)
+        g.offsets[v + 1] = g.offsets[v] + static_cast<int64_t>(neighbors[v].size());
+      g.targets.resize(static_cast<size_t>(g.offsets[n]));
+      parallel_for(pool, 0, n, [&](size_t lo, size_t hi, size_t) {
+        for (size_t v = lo; v < hi; ++v)
+          std::copy(neighbors[v].begin(), neighbors[v].end(),
+                    g.targets.begin() + static_cast<std::ptrdiff_t>(g.offsets[v]));
+      });
+      return g;
+    }
+
+    int intern(const std::string& node_id)
+    {
+      if (const int* known = node_index.find(node_id))
+        return *known;
+      int idx = static_cast<int>(node_ids.size());
+      node_index.mut(node_id) = idx;
+      node_ids.push_back(node_id);
+      node_props.push_back(nullptr);
+      neighbors.push_back({});
+      parent.push_back(idx);
+      members.push_back({});
+      members.mut(static_cast<size_t>(idx)).push_back(idx);
+      is_dirty.push_back(0);
+      mark_dirty(idx);
+      ++component_count;
+      centrality_stale = csr_stale = true;
+      return idx;
+    }
+
+    int find(int x)
+    {
+      for (;;)
+      {
+        const int p = parent[static_cast<size_t>(x)];
+        if (p == x)
+          return x;
+        const int gp = parent[static_cast<size_t>(p)];
+        if (gp != p)
+          parent.mut(static_cast<size_t>(x)) = gp;
+        x = gp;
+      }
+    }
+
+    /** Root lookup without path compression, for const queries (depth is O(log n) by union by size). */
+    int find_root(int x) const
+    {
+      while (parent[static_cast<size_t>(x)] != x)
+        x = parent[static_cast<size_t>(x)];
+      return x;
+    }
+
+    int component_id(const std::string& node_id) const
+    {
+      int i = index_of(node_id);
+      return i < 0 ? -1 : find_root(i);
+    }
+
+    void unite(int a, int b)
+    {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return;
+      if (members[static_cast<size_t>(a)].size() < members[static_cast<size_t>(b)].size())
+        std::swap(a, b);
+      parent.mut(static_cast<size_t>(b)) = a;
+      PersistentVector<int> small = std::move(members.mut(static_cast<size_t>(b)));
+      auto& big = members.mut(static_cast<size_t>(a));
+      for (int m : small)
+      {
+        mark_dirty(m);
+        big.push_back(m);
+      }
+      --component_count;
+    }
+
+    void mark_dirty(int x)
+    {
+      if (!is_dirty[static_cast<size_t>(x)])
+      {
+        is_dirty.mut(static_cast<size_t>(x)) = 1;
+        dirty.push_back(x);
+      }
+    }
+  };
+
+  /** Neighbor ids of one node, as the iterable of `const std::string&` that `build_subgraph` expects. */
+  struct NeighborIds
+  {
+    struct iterator
+    {
+      const Data* d;
+      PersistentVector<int>::const_iterator it;
+
+      const std::string& operator*() const
+      {
+        return d->node_ids[static_cast<size_t>(*it)];
+      }
+      iterator& operator++()
+      {
+        ++it;
+        return *this;
+      }
+      bool operator!=(const iterator& o) const
+      {
+        return it != o.it;
+      }
+    };
+
+    const Data* d;
+    const PersistentVector<int>* list;
+
+    iterator begin() const
+    {
+      return { d, list->begin() };
+    }
+    iterator end() const
+    {
+      return { d, list->end() };
+    }
+  };
+
+  void refresh_centrality(Data& d)
+  {
+    auto pool = analytics_pool();
+    if (d.csr_stale || !d.csr)
+    {
+      d.csr = std::make_shared<const CompactAdjacency>(d.build_csr(*pool));
+      d.csr_stale = false;
+    }
+    d.pagerank = std::make_shared<const std::vector<double>>(
+        pagerank(*d.csr, pagerank_param_, *pool, {}, d.pagerank ? *d.pagerank : std::vector<double>{}));
+    d.centrality_stale = false;
+  }
+
+  /** Workers for the analytics, started on first use and kept across calls. */
+  std::shared_ptr<ThreadPool> analytics_pool() const
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!pool_)
+      pool_ = std::make_shared<ThreadPool>(pagerank_param_.num_threads);
+    return pool_;
+  }
+
+  /** Read-only view over a pinned version (see `snapshot()`). */
+  InMemoryGraphStorage(const std::string& ns, std::shared_ptr<Data> pinned) : working_(std::move(pinned))
+  {
+    this->namespace_name = ns;
+  }
+
+  /** Version visible to readers: the published snapshot, or the live data without snapshot mode. */
+  std::shared_ptr<const Data> read() const
+  {
+    if (snapshot_reads_)
+      return std::atomic_load(&published_);
+    return working_;
+  }
+
+  /** Writer-side version; on the first write after a publish, a structure-sharing copy of the snapshot. */
+  Data& write()
   {
-    return s < t ? std::make_pair(s, t) : std::make_pair(t, s);
+    if (!working_)
+      working_ = std::make_shared<Data>(*std::atomic_load(&published_));
+    return *working_;
   }
 
-  static inline std::string canonical_edge_key_str(const std::string& s, const std::string& t)
+  /** Cluster id from a `clusters` attribute (`[{"level":0,"cluster":N}]`); 0 if absent. */
+  static inline int parse_cluster(const std::string& clusters)
   {
-    auto p = canonical_edge_key(s, t);
-    return p.first + "|" + p.second;
+    auto pos = clusters.find("cluster\":");
+    if (pos == std::string::npos)
+      return 0;
+    return static_cast<int>(std::strtol(clusters.c_str() + pos + 9, nullptr, 10));
+  }
+
+  static constexpr size_t kParallelSortMin = 1 << 16;  // edge count above which a community sorts in parallel
+
+  static inline bool parse_bool(const std::unordered_map<std::string, std::string>& cfg,
+                                const std::string& key, bool def)
+  {
+    auto it = cfg.find(key);
+    if (it == cfg.end())
+      return def;
+    std::string v = it->second;
+    std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    return (v == "1" || v == "true" || v == "yes");
+  }
+
+  static inline double parse_double(const std::unordered_map<std::string, std::string>& cfg,
+                                    const std::string& key, double def)
+  {
+    auto it = cfg.find(key);
+    if (it == cfg.end())
+      return def;
+    try
+    {
+      return std::stod(it->second);
+    }
+    catch (...)
+    {
+      return def;
+    }
   }
 
-  std::unordered_map<std::string, std::unordered_map<std::string, std::string>> nodes_;
-  std::unordered_map<std::string, std::unordered_map<std::string, std::string>> edges_;
-  std::unordered_map<std::string, std::unordered_set<std::string>> adjacency_;
+  bool snapshot_reads_{ false };
+  bool auto_centrality_{ false };
+  PageRankParam pagerank_param_;
+  std::shared_ptr<Data> working_;          // writers' version (null right after a publish)
+  std::shared_ptr<const Data> published_;  // readers' version in snapshot mode
+  std::mutex write_mutex_;                 // serializes writers; readers never take it
+  mutable std::mutex pool_mutex_;
+  mutable std::shared_ptr<ThreadPool> pool_;  // analytics workers (see `analytics_pool`)
 };
 
 }  // namespace nano_graphrag
@@ -118,17 +118,15 @@ public:
       }
       metas_[kv.first] = std::move(meta);
     }
-    std::vector<std::vector<float>> embeddings;
-
+    // One contiguous matrix per batch; each row is copied once, into the index's vector
+    EmbeddingMatrix embeddings;
+    const size_t dim = embedding_strategy ? embedding_strategy->embedding_dim() : 0;
     if (embedding_strategy)
-      embeddings = embedding_strategy->embed(contents);
-    debug_log("[NanoVectorDBStorage] embeddings size=", embeddings.size());
+      embedding_strategy->embed_into(contents, embeddings);
+    debug_log("[NanoVectorDBStorage] embeddings rows=", embeddings.rows);
 
-    if (embeddings.size() != ids.size())
-    {
-      size_t dim = embedding_strategy ? embedding_strategy->embedding_dim() : 0;
-      embeddings.assign(ids.size(), std::vector<float>(dim, 0.0f));
-    }
+    if (embeddings.rows != ids.size() || embeddings.dim != dim)
+      embeddings.resize(ids.size(), dim);
 
     if (!db_ && embedding_strategy && embedding_strategy->embedding_dim() > 0)
     {
@@ -145,10 +143,8 @@ public:
 
     for (size_t i = 0; i < ids.size(); ++i)
     {
-      Eigen::VectorXf v(static_cast<int>(embeddings[i].size()));
-      for (int j = 0; j < v.size(); ++j)
-        v[j] = embeddings[i][j];
-      datas.push_back({ ids[i], v });
+      Eigen::Map<const Eigen::VectorXf> row(embeddings.row(i), static_cast<Eigen::Index>(dim));
+      datas.push_back({ ids[i], row });
     }
     if (db_)
     {
@@ -169,21 +165,17 @@ public:
                                                                   int top_k) override
   {
     debug_log("[NanoVectorDBStorage] query top_k=", top_k);
-    std::vector<std::vector<float>> qembs;
+    EmbeddingMatrix qemb;
+    const size_t dim = embedding_strategy ? embedding_strategy->embedding_dim() : 0;
     if (embedding_strategy)
-      qembs = embedding_strategy->embed(std::vector<std::string>{ query });
-    debug_log("[NanoVectorDBStorage] query embed done size=", qembs.size());
-    std::vector<float> q;
-    if (!qembs.empty())
-      q = qembs[0];
-    else
-      q.assign(embedding_strategy ? embedding_strategy->embedding_dim() : 0, 0.0f);
+      embedding_strategy->embed_into(std::vector<std::string>{ query }, qemb);
+    debug_log("[NanoVectorDBStorage] query embed done rows=", qemb.rows);
+    if (qemb.rows != 1 || qemb.dim != dim)
+      qemb.resize(1, dim);
     std::vector<std::unordered_map<std::string, std::string>> out;
     if (db_)
     {
-      Eigen::VectorXf v(static_cast<int>(q.size()));
-      for (int i = 0; i < v.size(); ++i)
-        v[i] = q[i];
+      Eigen::Map<const Eigen::VectorXf> v(qemb.row(0), static_cast<Eigen::Index>(dim));
       std::optional<float> th = std::nullopt;
       if (cosine_better_than_threshold_ > 0.0)
         th = static_cast<float>(cosine_better_than_threshold_);
@@ -0,0 +1,481 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nano_graphrag/operations/tokenize/base.hpp"
+#include "nano_graphrag/utils/Hash.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Persistent per-document tokenization results, so re-chunking skips the tokenizer
+ *
+ * Entries are keyed by a hash of the document text and its length, and the whole
+ * file is tied to one tokenizer name; a file written by another tokenizer is
+ * ignored and overwritten. An entry holds the document's token offsets, its
+ * token ids, or both: inserting the kind an entry lacks keeps the other, so
+ * chunkers that want different kinds share one record per document.
+ *
+ * On disk the file is a small header followed by append-only records; token ids
+ * and offset deltas are stored as LEB128 varints, so typical text costs two to
+ * three bytes per token. Only an index (key, length, file position) is kept in
+ * memory. A truncated trailing record (e.g. after a crash) is dropped on load.
+ * New entries are held in memory until `flush()`, which writes each at most
+ * once. A record replaced by a later one for the same document stays in the
+ * file until a load finds such dead records outweigh the live ones and rewrites
+ * the file without them.
+ *
+ * All methods are thread-safe.
+ */
+class TokenCache
+{
+public:
+  /**
+   * @brief Tokenization result of one document
+   */
+  struct Entry
+  {
+    std::vector<int> ids;              // set for chunkers that cut token windows
+    std::vector<TokenOffset> offsets;  // set for chunkers that cut by byte ranges
+  };
+
+  /**
+   * @brief Open (or create on first flush) the cache file at `path`
+   *
+   * @param path Sidecar file path
+   * @param tokenizer_name Identity of the tokenizer, see `ITokenizerStrategy::name()`
+   */
+  TokenCache(std::string path, std::string tokenizer_name)
+    : path_(std::move(path))
+    , tokenizer_name_(std::move(tokenizer_name))
+  {
+    load();
+  }
+
+  /**
+   * @brief Cache key of a document: 64-bit hash of its bytes and length
+   */
+  static uint64_t key(std::string_view doc)
+  {
+    return hash_bytes64(doc);
+  }
+
+  /**
+   * @brief Cached result for `doc`, or null on a miss
+   *
+   * Flushed entries are read back from the file on each lookup, so memory holds
+   * only the index and entries not yet flushed.
+   */
+  std::shared_ptr<const Entry> find(std::string_view doc) const
+  {
+    const uint64_t k = key(doc);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(k);
+    if (it == entries_.end() || it->second.doc_size != doc.size())
+    {
+      ++misses_;
+      return nullptr;
+    }
+    auto entry = read(it->second);
+    ++(entry ? hits_ : misses_);
+    return entry;
+  }
+
+  /**
+   * @brief Store the result for `doc`; written to disk at the next `flush()`
+   *
+   * A kind of result that `entry` lacks (ids or offsets) is kept from the entry
+   * already cached for `doc`, if any.
+   */
+  std::shared_ptr<const Entry> insert(std::string_view doc, Entry entry)
+  {
+    const uint64_t k = key(doc);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = entries_[k];
+    if (slot.doc_size == doc.size() && (slot.entry || slot.payload_bytes))
+    {
+      if (auto old = read(slot))
+      {
+        if (entry.ids.empty())
+          entry.ids = old->ids;
+        if (entry.offsets.empty())
+          entry.offsets = old->offsets;
+      }
+    }
+    if (!slot.entry)
+      pending_.push_back(k);  // not queued yet
+    slot.doc_size = doc.size();
+    slot.entry = std::make_shared<const Entry>(std::move(entry));
+    return slot.entry;
+  }
+
+  /**
+   * @brief Append buffered entries to the file (rewriting it if it belongs to another tokenizer)
+   */
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty())
+      return;
+    const auto dir = std::filesystem::path(path_).parent_path();
+    if (!dir.empty())
+      std::filesystem::create_directories(dir);
+    if (!header_ok_)
+      reader_.close();  // the file is about to be replaced
+    std::ofstream out(path_, std::ios::binary | (header_ok_ ? std::ios::app : std::ios::trunc));
+    if (!out)
+      return;
+    std::string buf;
+    if (!header_ok_)
+    {
+      buf = header();
+      file_size_ = 0;
+    }
+    std::string payload;
+    for (uint64_t k : pending_)
+    {
+      auto it = entries_.find(k);
+      if (it == entries_.end() || !it->second.entry)
+        continue;
+      payload.clear();
+      encode_payload(*it->second.entry, payload);
+      put_varint(buf, k);
+      put_varint(buf, it->second.doc_size);
+      put_varint(buf, payload.size());
+      it->second.file_pos = file_size_ + buf.size();
+      it->second.payload_bytes = payload.size();
+      buf += payload;
+    }
+    if (!out.write(buf.data(), static_cast<std::streamsize>(buf.size())).flush())
+      return;  // keep the entries in memory and retry at the next flush
+    header_ok_ = true;
+    file_size_ += buf.size();
+    for (uint64_t k : pending_)
+    {
+      auto it = entries_.find(k);
+      if (it != entries_.end())
+        it->second.entry.reset();
+    }
+    pending_.clear();
+  }
+
+  /** Number of cached documents. */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  /** Lookups answered from the cache since construction. */
+  size_t hits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /** Lookups that missed since construction. */
+  size_t misses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  const std::string& path() const
+  {
+    return path_;
+  }
+
+  const std::string& tokenizer_name() const
+  {
+    return tokenizer_name_;
+  }
+
+private:
+  struct Slot
+  {
+    size_t doc_size{ 0 };
+    uint64_t file_pos{ 0 };       // payload position in the file, once flushed
+    uint64_t payload_bytes{ 0 };
+    std::shared_ptr<const Entry> entry;  // set until flushed
+  };
+
+  static constexpr char kMagic[4] = { 'N', 'G', 'T', 'C' };
+  static constexpr uint64_t kVersion = 2;
+  enum : uint64_t
+  {
+    kIds = 0,
+    kOffsets = 1
+  };
+
+  static void put_varint(std::string& buf, uint64_t v)
+  {
+    while (v >= 0x80)
+    {
+      buf.push_back(static_cast<char>(v | 0x80));
+      v >>= 7;
+    }
+    buf.push_back(static_cast<char>(v));
+  }
+
+  static bool get_varint(const char*& p, const char* end, uint64_t& v)
+  {
+    if (p < end && !(*p & 0x80))
+    {
+      v = static_cast<unsigned char>(*p++);  // common case: one byte
+      return true;
+    }
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+      const auto byte = static_cast<unsigned char>(*p++);
+      v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  static bool get_varint(std::istream& in, uint64_t& v)
+  {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      int c = in.get();
+      if (c == std::char_traits<char>::eof())
+        return false;
+      v |= static_cast<uint64_t>(c & 0x7F) << shift;
+      if (!(c & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  std::string header() const
+  {
+    std::string buf(kMagic, sizeof(kMagic));
+    put_varint(buf, kVersion);
+    put_varint(buf, tokenizer_name_.size());
+    buf += tokenizer_name_;
+    return buf;
+  }
+
+  // Caller holds mutex_; the slot's entry, from memory or read back from the file
+  std::shared_ptr<const Entry> read(const Slot& slot) const
+  {
+    if (slot.entry)
+      return slot.entry;
+    if (!reader_.is_open())
+      reader_.open(path_, std::ios::binary);
+    reader_.clear();
+    reader_.seekg(static_cast<std::streamoff>(slot.file_pos));
+    std::string payload(slot.payload_bytes, '\0');
+    auto entry = std::make_shared<Entry>();
+    if (!reader_.read(&payload[0], static_cast<std::streamsize>(payload.size())) ||
+        !decode_payload(payload, *entry))
+      return nullptr;
+    return entry;
+  }
+
+  // Payload: one section per kind present (offsets, then ids), each the kind, the
+  // count, then per token an id or (gap from the previous end, length)
+  static void encode_payload(const Entry& e, std::string& buf)
+  {
+    if (!e.offsets.empty() || e.ids.empty())
+    {
+      put_varint(buf, kOffsets);
+      put_varint(buf, e.offsets.size());
+      size_t prev_end = 0;
+      for (const auto& off : e.offsets)
+      {
+        // offsets are increasing in practice; fall back to an absolute position otherwise
+        const bool forward = off.begin >= prev_end;
+        put_varint(buf, forward ? (off.begin - prev_end) << 1 : (off.begin << 1) | 1);
+        put_varint(buf, off.end - off.begin);
+        prev_end = off.end;
+      }
+    }
+    if (!e.ids.empty())
+    {
+      put_varint(buf, kIds);
+      put_varint(buf, e.ids.size());
+      for (int id : e.ids)
+        put_varint(buf, static_cast<uint32_t>(id));
+    }
+  }
+
+  static bool decode_payload(const std::string& payload, Entry& e)
+  {
+    const char* p = payload.data();
+    const char* end = p + payload.size();
+    do
+    {
+      if (!decode_section(p, end, e))
+        return false;
+    } while (p < end);
+    return true;
+  }
+
+  static bool decode_section(const char*& p, const char* end, Entry& e)
+  {
+    uint64_t kind, count;
+    if (!get_varint(p, end, kind) || !get_varint(p, end, count) || count > static_cast<uint64_t>(end - p))
+      return false;
+    if (kind == kOffsets)
+    {
+      e.offsets.resize(count);
+      TokenOffset* out = e.offsets.data();
+      size_t prev_end = 0;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        uint64_t pos, len;
+        if (!get_varint(p, end, pos) || !get_varint(p, end, len))
+          return false;
+        const size_t begin = (pos & 1) ? (pos >> 1) : prev_end + (pos >> 1);
+        prev_end = begin + len;
+        out[i] = TokenOffset{ begin, prev_end };
+      }
+      return true;
+    }
+    if (kind == kIds)
+    {
+      e.ids.resize(count);
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        uint64_t id;
+        if (!get_varint(p, end, id))
+          return false;
+        e.ids[i] = static_cast<int>(static_cast<uint32_t>(id));
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // Build the index from record headers, skipping payloads
+  void load()
+  {
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(path_, ec);
+    std::ifstream in(path_, std::ios::binary);
+    if (ec || !in)
+      return;
+    char magic[sizeof(kMagic)];
+    uint64_t version, name_len;
+    if (!in.read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) !=
+                                              std::string_view(kMagic, sizeof(kMagic)) ||
+        !get_varint(in, version) || version != kVersion || !get_varint(in, name_len) || name_len > size)
+      return;
+    std::string name(name_len, '\0');
+    if (!in.read(&name[0], static_cast<std::streamsize>(name_len)) || name != tokenizer_name_)
+      return;
+    header_ok_ = true;
+    uint64_t valid_end = static_cast<uint64_t>(in.tellg());
+    uint64_t dead_bytes = 0;  // payloads of records replaced by a later one
+    uint64_t live_bytes = 0;
+    for (;;)
+    {
+      uint64_t k, doc_size, payload_bytes;
+      if (!get_varint(in, k) || !get_varint(in, doc_size) || !get_varint(in, payload_bytes))
+        break;
+      const uint64_t pos = static_cast<uint64_t>(in.tellg());
+      if (payload_bytes > size - pos)
+        break;
+      Slot& slot = entries_[k];
+      dead_bytes += slot.payload_bytes;
+      live_bytes += payload_bytes - slot.payload_bytes;
+      slot.doc_size = doc_size;
+      slot.file_pos = pos;
+      slot.payload_bytes = payload_bytes;
+      in.seekg(static_cast<std::streamoff>(payload_bytes), std::ios::cur);
+      valid_end = pos + payload_bytes;
+    }
+    file_size_ = valid_end;
+    in.close();
+    if (dead_bytes > live_bytes)
+      compact();  // also drops a torn tail
+    else if (valid_end != size)
+      std::filesystem::resize_file(path_, valid_end, ec);  // later appends start at a record boundary
+  }
+
+  // Rewrite the file with only the indexed records, in file order; on failure the old file stays
+  void compact()
+  {
+    std::vector<std::pair<uint64_t, Slot*>> live;
+    live.reserve(entries_.size());
+    for (auto& kv : entries_)
+      live.emplace_back(kv.first, &kv.second);
+    std::sort(live.begin(), live.end(),
+              [](const auto& a, const auto& b) { return a.second->file_pos < b.second->file_pos; });
+
+    const std::string tmp = path_ + ".tmp";
+    std::ifstream in(path_, std::ios::binary);
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    std::string buf = header();
+    uint64_t written = 0;
+    std::vector<uint64_t> positions;
+    positions.reserve(live.size());
+    std::string payload;
+    for (const auto& rec : live)
+    {
+      payload.resize(rec.second->payload_bytes);
+      in.seekg(static_cast<std::streamoff>(rec.second->file_pos));
+      if (!in.read(&payload[0], static_cast<std::streamsize>(payload.size())))
+        break;
+      put_varint(buf, rec.first);
+      put_varint(buf, rec.second->doc_size);
+      put_varint(buf, payload.size());
+      positions.push_back(written + buf.size());
+      buf += payload;
+      if (buf.size() >= (1u << 20))
+      {
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        written += buf.size();
+        buf.clear();
+      }
+    }
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    written += buf.size();
+    std::error_code ec;
+    if (positions.size() != live.size() || !out.flush())
+    {
+      out.close();
+      std::filesystem::remove(tmp, ec);
+      return;
+    }
+    out.close();
+    in.close();
+    std::filesystem::rename(tmp, path_, ec);
+    if (ec)
+    {
+      std::filesystem::remove(tmp, ec);
+      return;
+    }
+    for (size_t i = 0; i < live.size(); ++i)
+      live[i].second->file_pos = positions[i];
+    file_size_ = written;
+  }
+
+  std::string path_;
+  std::string tokenizer_name_;
+  mutable std::mutex mutex_;
+  mutable std::ifstream reader_;  // opened on the first lookup of a flushed entry
+  std::unordered_map<uint64_t, Slot> entries_;
+  std::vector<uint64_t> pending_;
+  bool header_ok_{ false };
+  uint64_t file_size_{ 0 };
+  mutable size_t hits_{ 0 };
+  mutable size_t misses_{ 0 };
+};
+
+}  // namespace nano_graphrag
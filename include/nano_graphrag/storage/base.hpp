@@ -2,9 +2,14 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <optional>
 #include <utility>
+#include <tuple>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 
 // EmbeddingFunc declaration is expected from Embedding.hpp (to be provided)
 // Types are defined under utils
@@ -171,6 +176,164 @@ public:
   virtual void clustering(const std::string& algorithm) = 0;
   /** Return a `community_schema` view of clusters/communities. */
   virtual std::unordered_map<std::string, SingleCommunity> community_schema() const = 0;
+
+  /**
+   * @brief Batch k-hop neighborhood lookup around a set of seed nodes.
+   *
+   * Expands breadth-first from the seeds for `param.max_hops` hops. At each hop the
+   * highest-ranked nodes are expanded first and their neighbors are visited in
+   * descending rank order, so truncation by `max_neighbors_per_node`, `max_nodes`
+   * or `max_edges` keeps the best-connected part of the neighborhood. Nodes rank by
+   * degree, or by PageRank with `param.rank_by_centrality` on storages that compute
+   * it (the default implementation does not). Unknown seeds are skipped.
+   *
+   * The default implementation is built on the per-node accessors; backends with
+   * direct adjacency access should override it.
+   *
+   * @param seeds Seed node ids (hop 0).
+   * @param param Hop count and truncation budgets.
+   * @return Flat node/edge lists; edges are the ones traversed during expansion.
+   */
+  virtual Subgraph get_subgraph(const std::vector<std::string>& seeds, const SubgraphParam& param = {}) const
+  {
+    return build_subgraph(
+        seeds, param, [this](const std::string& id) { return has_node(id); },
+        [this](const std::string& id) {
+          std::vector<std::string> out;
+          for (auto& e : get_node_edges(id))
+            out.push_back(std::move(e.second));
+          return out;
+        },
+        [this](const std::string& id) { return node_degree(id); },
+        [](const std::string&, int degree) { return static_cast<double>(degree); },
+        [this](const std::string& id) { return get_node(id); },
+        [this](const std::string& s, const std::string& t) { return get_edge(s, t); });
+  }
+
+protected:
+  /**
+   * @brief Shared expansion routine behind `get_subgraph`.
+   *
+   * `neighbors(id)` must return an iterable of neighbor ids that stays alive while the
+   * node is being expanded; `rank(id, degree)` returns the ordering key of a node;
+   * `node_props`/`edge_props` return optional property maps.
+   */
+  template <typename HasNode, typename Neighbors, typename Degree, typename Rank, typename NodeProps,
+            typename EdgeProps>
+  static Subgraph build_subgraph(const std::vector<std::string>& seeds, const SubgraphParam& param,
+                                 HasNode&& has_node, Neighbors&& neighbors, Degree&& degree, Rank&& rank,
+                                 NodeProps&& node_props, EdgeProps&& edge_props)
+  {
+    Subgraph out;
+    std::unordered_map<std::string, int> index;  // node id -> position in out.nodes
+    std::unordered_set<uint64_t> seen_edges;     // packed (min index, max index)
+
+    auto node_budget_left = [&]() {
+      return param.max_nodes <= 0 || static_cast<int>(out.nodes.size()) < param.max_nodes;
+    };
+    auto edge_budget_left = [&]() {
+      return param.max_edges <= 0 || static_cast<int>(out.edges.size()) < param.max_edges;
+    };
+    auto add_node = [&](const std::string& id, int hop, int deg, double r) {
+      int pos = static_cast<int>(out.nodes.size());
+      Subgraph::Node n;
+      n.id = id;
+      n.degree = deg;
+      n.hop = hop;
+      n.rank = r;
+      if (param.with_properties)
+      {
+        auto props = node_props(id);
+        if (props)
+          n.properties = std::move(*props);
+      }
+      out.nodes.push_back(std::move(n));
+      index.emplace(id, pos);
+      return pos;
+    };
+
+    for (const auto& s : seeds)
+    {
+      if (!node_budget_left())
+        break;
+      if (index.count(s) || !has_node(s))
+        continue;
+      int deg = degree(s);
+      add_node(s, 0, deg, rank(s, deg));
+    }
+
+    size_t frontier_begin = 0;
+    std::vector<int> order;
+    struct Candidate
+    {
+      double rank;
+      int degree;
+      const std::string* id;
+    };
+    std::vector<Candidate> candidates;
+    for (int hop = 0; hop < param.max_hops && edge_budget_left(); ++hop)
+    {
+      size_t frontier_end = out.nodes.size();
+      if (frontier_begin == frontier_end)
+        break;
+      order.clear();
+      for (size_t i = frontier_begin; i < frontier_end; ++i)
+        order.push_back(static_cast<int>(i));
+      std::stable_sort(order.begin(), order.end(),
+                       [&](int a, int b) { return out.nodes[a].rank > out.nodes[b].rank; });
+
+      for (int u : order)
+      {
+        if (!edge_budget_left())
+          break;
+        const std::string uid = out.nodes[u].id;  // out.nodes may grow below
+        auto&& nbrs = neighbors(uid);
+        candidates.clear();
+        for (const auto& nb : nbrs)
+        {
+          int deg = degree(nb);
+          candidates.push_back(Candidate{ rank(nb, deg), deg, &nb });
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+          return a.rank != b.rank ? a.rank > b.rank : *a.id < *b.id;
+        });
+        if (param.max_neighbors_per_node > 0 &&
+            static_cast<int>(candidates.size()) > param.max_neighbors_per_node)
+          candidates.resize(static_cast<size_t>(param.max_neighbors_per_node));
+
+        for (const auto& c : candidates)
+        {
+          if (!edge_budget_left())
+            break;
+          int v;
+          auto it = index.find(*c.id);
+          if (it != index.end())
+            v = it->second;
+          else if (node_budget_left())
+            v = add_node(*c.id, hop + 1, c.degree, c.rank);
+          else
+            continue;
+          uint64_t key =
+              (static_cast<uint64_t>(std::min(u, v)) << 32) | static_cast<uint32_t>(std::max(u, v));
+          if (!seen_edges.insert(key).second)
+            continue;
+          Subgraph::Edge e;
+          e.source = u;
+          e.target = v;
+          e.degree = out.nodes[u].degree + out.nodes[v].degree;
+          if (param.with_properties)
+          {
+            auto props = edge_props(uid, out.nodes[v].id);
+            if (props)
+              e.properties = std::move(*props);
+          }
+          out.edges.push_back(std::move(e));
+        }
+      }
+      frontier_begin = frontier_end;
+    }
+    return out;
+  }
 };
 
 }  // namespace nano_graphrag
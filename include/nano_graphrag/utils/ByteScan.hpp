@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_bitops)
+#include <bit>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// MSVC does not define __SSE2__, but SSE2 is baseline on x64
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Whether `c` separates words for whitespace tokenization (space, newline, tab).
+ */
+inline bool is_word_separator(char c)
+{
+  return c == ' ' || c == '\n' || c == '\t';
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero mask.
+ */
+inline unsigned lowest_set_bit64(uint64_t mask)
+{
+#if defined(__cpp_lib_bitops)
+  return static_cast<unsigned>(std::countr_zero(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long i;
+  _BitScanForward64(&i, mask);
+  return static_cast<unsigned>(i);
+#elif defined(_MSC_VER)
+  unsigned long i;
+  if (_BitScanForward(&i, static_cast<unsigned long>(mask)))
+    return static_cast<unsigned>(i);
+  _BitScanForward(&i, static_cast<unsigned long>(mask >> 32));
+  return static_cast<unsigned>(i) + 32;
+#else
+  return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * @brief Number of set bits in a mask.
+ */
+inline unsigned popcount64(uint64_t mask)
+{
+#if defined(__cpp_lib_bitops)
+  return static_cast<unsigned>(std::popcount(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<unsigned>(__popcnt64(mask));
+#elif defined(_MSC_VER)
+  mask -= (mask >> 1) & 0x5555555555555555ull;
+  mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+  mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return static_cast<unsigned>((mask * 0x0101010101010101ull) >> 56);
+#else
+  return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+}
+
+/**
+ * @brief First position at or after `pos` that does not fall inside a multi-byte UTF-8 character.
+ */
+inline size_t utf8_boundary(std::string_view text, size_t pos)
+{
+  pos = pos < text.size() ? pos : text.size();
+  while (pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80)
+    ++pos;
+  return pos;
+}
+
+/**
+ * @brief Bit `i` of the result is set if `p[i]` equals one of `Cs`, for 64 bytes at `p`.
+ *
+ * Uses AVX2 (two 32-byte compares per character) or SSE2 (four 16-byte compares)
+ * when the target supports them, otherwise a scalar loop.
+ */
+template <char... Cs>
+inline uint64_t byte_mask64(const char* p)
+{
+#if defined(__AVX2__)
+  uint64_t mask = 0;
+  for (int half = 0; half < 2; ++half)
+  {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * half));
+    __m256i m = _mm256_setzero_si256();
+    ((m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(Cs)))), ...);
+    mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(m))) << (32 * half);
+  }
+  return mask;
+#elif defined(__SSE2__) || defined(_M_X64)
+  uint64_t mask = 0;
+  for (int quarter = 0; quarter < 4; ++quarter)
+  {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * quarter));
+    __m128i m = _mm_setzero_si128();
+    ((m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8(Cs)))), ...);
+    mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(m))) << (16 * quarter);
+  }
+  return mask;
+#else
+  uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i)
+    mask |= static_cast<uint64_t>(((p[i] == Cs) || ...)) << i;
+  return mask;
+#endif
+}
+
+/**
+ * @brief Bit `i` of the result is set if `p[i]` is a word separator, for 64 bytes at `p`.
+ */
+inline uint64_t separator_mask64(const char* p)
+{
+  return byte_mask64<' ', '\n', '\t'>(p);
+}
+
+/**
+ * @brief Call `fn(pos)` for every position in `text` whose byte equals one of `Cs`, in order.
+ *
+ * Scans 64 bytes per step with `byte_mask64`; the tail is copied into a padded block.
+ */
+template <char... Cs, typename Fn>
+inline void for_each_byte_of(std::string_view text, Fn&& fn)
+{
+  const size_t n = text.size();
+  for (size_t base = 0; base < n; base += 64)
+  {
+    uint64_t mask;
+    if (base + 64 <= n)
+      mask = byte_mask64<Cs...>(text.data() + base);
+    else
+    {
+      char tail[64] = {};
+      std::memcpy(tail, text.data() + base, n - base);
+      mask = byte_mask64<Cs...>(tail) & ((uint64_t{ 1 } << (n - base)) - 1);
+    }
+    for (; mask; mask &= mask - 1)
+      fn(base + static_cast<size_t>(lowest_set_bit64(mask)));
+  }
+}
+
+/**
+ * @brief Call `fn(begin, end)` for every maximal run of non-separator bytes, in order.
+ *
+ * The text is classified 64 bytes per step; word starts and ends are found from
+ * transitions in the separator mask, so the per-byte work is a few bit operations.
+ */
+template <typename Fn>
+inline void for_each_word(std::string_view text, Fn&& fn)
+{
+  const size_t n = text.size();
+  uint64_t prev_sep = 1;  // the position before the text counts as a separator
+  size_t word_begin = 0;
+  for (size_t base = 0; base < n; base += 64)
+  {
+    uint64_t sep;
+    if (base + 64 <= n)
+      sep = separator_mask64(text.data() + base);
+    else
+    {
+      // pad the tail with separators so the last word ends inside this block
+      char tail[64];
+      std::memset(tail, ' ', sizeof(tail));
+      std::memcpy(tail, text.data() + base, n - base);
+      sep = separator_mask64(tail);
+    }
+    uint64_t before = (sep << 1) | prev_sep;  // separator state of the previous byte
+    uint64_t starts = ~sep & before;
+    uint64_t ends = sep & ~before;
+    prev_sep = sep >> 63;
+    for (uint64_t edges = starts | ends; edges; edges &= edges - 1)
+    {
+      unsigned i = lowest_set_bit64(edges);
+      if (starts >> i & 1)
+        word_begin = base + i;
+      else
+        fn(word_begin, base + i);
+    }
+  }
+  if (!prev_sep)
+    fn(word_begin, n);
+}
+
+/**
+ * @brief Number of whitespace-separated words in `text`.
+ */
+inline size_t count_words(std::string_view text)
+{
+  const size_t n = text.size();
+  size_t count = 0;
+  uint64_t prev_sep = 1;
+  for (size_t base = 0; base < n; base += 64)
+  {
+    uint64_t sep;
+    if (base + 64 <= n)
+      sep = separator_mask64(text.data() + base);
+    else
+    {
+      char tail[64];
+      std::memset(tail, ' ', sizeof(tail));
+      std::memcpy(tail, text.data() + base, n - base);
+      sep = separator_mask64(tail);
+    }
+    count += static_cast<size_t>(popcount64(~sep & ((sep << 1) | prev_sep)));
+    prev_sep = sep >> 63;
+  }
+  return count;
+}
+
+}  // namespace nano_graphrag
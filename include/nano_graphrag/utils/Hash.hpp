@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte string.
+ */
+inline uint64_t fnv1a64(std::string_view data, uint64_t seed = 0xcbf29ce484222325ull)
+{
+  uint64_t h = seed;
+  for (unsigned char c : data)
+  {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+/**
+ * @brief SplitMix64 finalizer; a cheap, well-mixed 64-bit permutation.
+ */
+inline uint64_t mix64(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief 64-bit hash of a byte string that consumes 32 bytes per step.
+ *
+ * Four independent multiply-rotate lanes keep the loop throughput-bound, so it
+ * is much faster than `fnv1a64` on long inputs such as whole documents. Not
+ * interchangeable with `fnv1a64`.
+ */
+inline uint64_t hash_bytes64(std::string_view data, uint64_t seed = 0)
+{
+  constexpr uint64_t kMul = 0x9FB21C651E98DF25ull;
+  auto lane = [](uint64_t h, uint64_t word) {
+    h ^= word * kMul;
+    return ((h << 29) | (h >> 35)) * kMul;
+  };
+  uint64_t h[4] = { mix64(seed), mix64(seed + 1), mix64(seed + 2), mix64(seed + 3) };
+  const char* p = data.data();
+  size_t n = data.size();
+  for (; n >= 32; p += 32, n -= 32)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      uint64_t word;
+      std::memcpy(&word, p + 8 * i, 8);
+      h[i] = lane(h[i], word);
+    }
+  }
+  uint64_t out = mix64(data.size()) ^ mix64(h[0]) ^ (mix64(h[1]) * 3) ^ (mix64(h[2]) * 5) ^ (mix64(h[3]) * 7);
+  for (; n >= 8; p += 8, n -= 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    out = mix64(out ^ word);
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, p, n);
+  return mix64(out ^ tail ^ (static_cast<uint64_t>(n) << 56));
+}
+
+}  // namespace nano_graphrag
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Number of hardware threads, at least 1.
+ */
+inline size_t hardware_threads()
+{
+  unsigned n = std::thread::hardware_concurrency();
+  return n ? static_cast<size_t>(n) : 1;
+}
+
+/**
+ * @brief Split `[begin, end)` into contiguous ranges and run them on separate threads.
+ *
+ * `fn(lo, hi, tid)` is called once per range with a dense thread index `tid` in
+ * `[0, num_threads)`, which callers can use to address per-thread accumulators.
+ * The calling thread runs range 0. The first exception thrown by any range is
+ * rethrown after all threads have joined.
+ *
+ * @param num_threads Number of ranges/threads; 0 means `hardware_threads()`.
+ * @return Number of ranges actually used (never more than the element count).
+ */
+template <typename Fn>
+inline size_t parallel_for(size_t begin, size_t end, size_t num_threads, Fn&& fn)
+{
+  if (end <= begin)
+    return 0;
+  size_t n = end - begin;
+  if (num_threads == 0)
+    num_threads = hardware_threads();
+  num_threads = std::min(num_threads, n);
+  if (num_threads <= 1)
+  {
+    fn(begin, end, size_t{ 0 });
+    return 1;
+  }
+
+  size_t step = (n + num_threads - 1) / num_threads;
+  num_threads = (n + step - 1) / step;
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads - 1);
+  for (size_t t = 1; t < num_threads; ++t)
+  {
+    size_t lo = begin + t * step;
+    size_t hi = std::min(end, lo + step);
+    workers.emplace_back([&fn, &errors, lo, hi, t]() {
+      try
+      {
+        fn(lo, hi, t);
+      }
+      catch (...)
+      {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  try
+  {
+    fn(begin, std::min(end, begin + step), size_t{ 0 });
+  }
+  catch (...)
+  {
+    errors[0] = std::current_exception();
+  }
+  for (auto& w : workers)
+    w.join();
+  for (auto& e : errors)
+    if (e)
+      std::rethrow_exception(e);
+  return num_threads;
+}
+
+/**
+ * @brief Sort a vector by sorting contiguous ranges in parallel and merging them pairwise.
+ *
+ * Falls back to `std::sort` for small inputs or a single thread.
+ */
+template <typename T, typename Compare = std::less<T>>
+inline void parallel_sort(std::vector<T>& v, size_t num_threads, Compare cmp = Compare{})
+{
+  constexpr size_t kMinPerThread = 1 << 14;
+  if (num_threads == 0)
+    num_threads = hardware_threads();
+  num_threads = std::min(num_threads, v.size() / kMinPerThread);
+  if (num_threads <= 1)
+  {
+    std::sort(v.begin(), v.end(), cmp);
+    return;
+  }
+
+  // sorted runs [bounds[i], bounds[i + 1])
+  std::vector<size_t> bounds;
+  size_t step = (v.size() + num_threads - 1) / num_threads;
+  for (size_t b = 0; b < v.size(); b += step)
+    bounds.push_back(b);
+  bounds.push_back(v.size());
+  parallel_for(0, bounds.size() - 1, num_threads, [&](size_t lo, size_t hi, size_t) {
+    for (size_t r = lo; r < hi; ++r)
+      std::sort(v.begin() + static_cast<std::ptrdiff_t>(bounds[r]),
+                v.begin() + static_cast<std::ptrdiff_t>(bounds[r + 1]), cmp);
+  });
+
+  while (bounds.size() > 2)
+  {
+    size_t pairs = (bounds.size() - 1) / 2;
+    parallel_for(0, pairs, num_threads, [&](size_t lo, size_t hi, size_t) {
+      for (size_t p = lo; p < hi; ++p)
+        std::inplace_merge(v.begin() + static_cast<std::ptrdiff_t>(bounds[2 * p]),
+                           v.begin() + static_cast<std::ptrdiff_t>(bounds[2 * p + 1]),
+                           v.begin() + static_cast<std::ptrdiff_t>(bounds[2 * p + 2]), cmp);
+    });
+    std::vector<size_t> merged;
+    for (size_t i = 0; i < bounds.size(); i += 2)
+      merged.push_back(bounds[i]);
+    if (merged.back() != v.size())
+      merged.push_back(v.size());
+    bounds.swap(merged);
+  }
+}
+
+}  // namespace nano_graphrag
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "nano_graphrag/utils/Hash.hpp"
+
+namespace nano_graphrag
+{
+
+namespace detail
+{
+/** Fresh id for a persistent container; nodes remember which container may write them in place. */
+inline uint64_t next_persistent_owner()
+{
+  static std::atomic<uint64_t> counter{ 0 };
+  return ++counter;
+}
+}  // namespace detail
+
+/**
+ * @brief Vector with O(1) copies that share structure (32-way trie with path copying).
+ *
+ * Elements live in leaves of 32 under inner nodes of 32 children. Copying the
+ * vector copies only the root pointer; afterwards neither copy writes a shared
+ * node in place. A write clones the nodes on its path that the writing copy
+ * does not own yet (one leaf and at most log32(n) inner nodes) and then owns
+ * them, so repeated writes to the same region are in place. A version derived
+ * from a snapshot therefore costs time and memory in proportion to what it
+ * changes, not to its size.
+ *
+ * Reads may run concurrently with anything except writes to the same copy.
+ * Copying re-keys the source as well (so it stops writing the now shared
+ * nodes), hence copies and writes of one object must not race each other.
+ */
+template <typename T>
+class PersistentVector
+{
+  static constexpr unsigned kBits = 5;
+  static constexpr size_t kWidth = size_t{ 1 } << kBits;
+  static constexpr size_t kMask = kWidth - 1;
+
+  struct Node
+  {
+    uint64_t owner{ 0 };
+    std::vector<std::shared_ptr<Node>> children;  // inner nodes
+    std::vector<T> values;                        // leaves
+  };
+
+public:
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator(const PersistentVector* v, size_t i)
+      : v_(v), i_(i), leaf_(i < v->size_ ? v->leaf(i) : nullptr)
+    {
+    }
+    reference operator*() const
+    {
+      return leaf_[i_ & kMask];
+    }
+    pointer operator->() const
+    {
+      return &leaf_[i_ & kMask];
+    }
+    const_iterator& operator++()
+    {
+      if ((++i_ & kMask) == 0 && i_ < v_->size_)
+        leaf_ = v_->leaf(i_);
+      return *this;
+    }
+    bool operator==(const const_iterator& o) const
+    {
+      return i_ == o.i_;
+    }
+    bool operator!=(const const_iterator& o) const
+    {
+      return i_ != o.i_;
+    }
+
+  private:
+    const PersistentVector* v_;
+    size_t i_;
+    const T* leaf_;
+  };
+
+  PersistentVector() = default;
+
+  PersistentVector(const PersistentVector& o) : root_(o.root_), size_(o.size_), shift_(o.shift_)
+  {
+    o.owner_ = detail::next_persistent_owner();  // the source must stop writing shared nodes too
+  }
+
+  PersistentVector& operator=(const PersistentVector& o)
+  {
+    if (this != &o)
+    {
+      root_ = o.root_;
+      size_ = o.size_;
+      shift_ = o.shift_;
+      owner_ = detail::next_persistent_owner();
+      o.owner_ = detail::next_persistent_owner();
+    }
+    return *this;
+  }
+
+  PersistentVector(PersistentVector&& o) noexcept
+    : root_(std::move(o.root_)), size_(o.size_), shift_(o.shift_), owner_(o.owner_)
+  {
+    o.size_ = 0;
+    o.shift_ = 0;
+    o.owner_ = detail::next_persistent_owner();
+  }
+
+  PersistentVector& operator=(PersistentVector&& o) noexcept
+  {
+    if (this != &o)
+    {
+      root_ = std::move(o.root_);
+      size_ = o.size_;
+      shift_ = o.shift_;
+      owner_ = o.owner_;
+      o.size_ = 0;
+      o.shift_ = 0;
+      o.owner_ = detail::next_persistent_owner();
+    }
+    return *this;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  const T& operator[](size_t i) const
+  {
+    return leaf(i)[i & kMask];
+  }
+
+  /** Writable reference to element `i`; clones the shared nodes on its path first. */
+  T& mut(size_t i)
+  {
+    std::shared_ptr<Node>* slot = &root_;
+    for (unsigned s = shift_; s > 0; s -= kBits)
+    {
+      own(*slot);
+      slot = &(*slot)->children[(i >> s) & kMask];
+    }
+    own(*slot);
+    return (*slot)->values[i & kMask];
+  }
+
+  void push_back(T value)
+  {
+    if (root_ && size_ == (kWidth << shift_))
+    {
+      auto grown = std::make_shared<Node>();
+      grown->owner = owner_;
+      grown->children.push_back(std::move(root_));
+      root_ = std::move(grown);
+      shift_ += kBits;
+    }
+    std::shared_ptr<Node>* slot = &root_;
+    for (unsigned s = shift_; s > 0; s -= kBits)
+    {
+      own(*slot);
+      auto& children = (*slot)->children;
+      const size_t c = (size_ >> s) & kMask;
+      if (c == children.size())
+        children.emplace_back();
+      slot = &children[c];
+    }
+    own(*slot);
+    (*slot)->values.push_back(std::move(value));
+    ++size_;
+  }
+
+  void clear()
+  {
+    root_.reset();
+    size_ = 0;
+    shift_ = 0;
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+  const_iterator end() const
+  {
+    return const_iterator(this, size_);
+  }
+
+private:
+  const T* leaf(size_t i) const
+  {
+    const Node* n = root_.get();
+    for (unsigned s = shift_; s > 0; s -= kBits)
+      n = n->children[(i >> s) & kMask].get();
+    return n->values.data();
+  }
+
+  // Make `slot` a node this vector may write: create it if missing, clone it if shared
+  void own(std::shared_ptr<Node>& slot)
+  {
+    if (!slot)
+    {
+      slot = std::make_shared<Node>();
+      slot->owner = owner_;
+    }
+    else if (slot->owner != owner_)
+    {
+      slot = std::make_shared<Node>(*slot);
+      slot->owner = owner_;
+    }
+  }
+
+  std::shared_ptr<Node> root_;
+  size_t size_{ 0 };
+  unsigned shift_{ 0 };
+  mutable uint64_t owner_{ detail::next_persistent_owner() };
+};
+
+/**
+ * @brief Hash map with O(1) copies that share structure (hash trie with path copying).
+ *
+ * Entries sit in small buckets at the leaves of a 32-way trie indexed by 5-bit
+ * slices of the mixed key hash; a full bucket splits into an inner node, so the
+ * trie never rehashes. Copies and writes behave as in `PersistentVector`: a
+ * write clones only the unowned nodes on its path.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class PersistentHashMap
+{
+  static constexpr unsigned kBits = 5;
+  static constexpr size_t kWidth = size_t{ 1 } << kBits;
+  static constexpr size_t kBucket = 8;               // entries before a bucket splits
+  static constexpr unsigned kMaxShift = 64 - kBits;  // past this level buckets grow instead
+
+  struct Entry
+  {
+    uint64_t hash;
+    K key;
+    V value;
+  };
+
+  struct Node
+  {
+    uint64_t owner{ 0 };
+    std::vector<std::shared_ptr<Node>> children;  // inner node: kWidth slots
+    std::vector<Entry> entries;                   // bucket
+  };
+
+public:
+  PersistentHashMap() = default;
+
+  PersistentHashMap(const PersistentHashMap& o) : root_(o.root_), size_(o.size_)
+  {
+    o.owner_ = detail::next_persistent_owner();
+  }
+
+  PersistentHashMap& operator=(const PersistentHashMap& o)
+  {
+    if (this != &o)
+    {
+      root_ = o.root_;
+      size_ = o.size_;
+      owner_ = detail::next_persistent_owner();
+      o.owner_ = detail::next_persistent_owner();
+    }
+    return *this;
+  }
+
+  PersistentHashMap(PersistentHashMap&& o) noexcept
+    : root_(std::move(o.root_)), size_(o.size_), owner_(o.owner_)
+  {
+    o.size_ = 0;
+    o.owner_ = detail::next_persistent_owner();
+  }
+
+  PersistentHashMap& operator=(PersistentHashMap&& o) noexcept
+  {
+    if (this != &o)
+    {
+      root_ = std::move(o.root_);
+      size_ = o.size_;
+      owner_ = o.owner_;
+      o.size_ = 0;
+      o.owner_ = detail::next_persistent_owner();
+    }
+    return *this;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  /** Value of `key`, or nullptr. */
+  const V* find(const K& key) const
+  {
+    const uint64_t h = hash(key);
+    const Node* n = root_.get();
+    for (unsigned s = 0; n && !n->children.empty(); s += kBits)
+      n = n->children[(h >> s) & (kWidth - 1)].get();
+    if (!n)
+      return nullptr;
+    for (const auto& e : n->entries)
+      if (e.hash == h && e.key == key)
+        return &e.value;
+    return nullptr;
+  }
+
+  bool contains(const K& key) const
+  {
+    return find(key) != nullptr;
+  }
+
+  /**
+   * @brief Writable value of `key`, inserted value-initialized if missing
+   * @param inserted Set to whether the key was new
+   */
+  V& mut(const K& key, bool* inserted = nullptr)
+  {
+    const uint64_t h = hash(key);
+    std::shared_ptr<Node>* slot = &root_;
+    unsigned s = 0;
+    for (;;)
+    {
+      own(*slot);
+      Node& n = **slot;
+      if (!n.children.empty())
+      {
+        slot = &n.children[(h >> s) & (kWidth - 1)];
+        s += kBits;
+        continue;
+      }
+      for (auto& e : n.entries)
+        if (e.hash == h && e.key == key)
+        {
+          if (inserted)
+            *inserted = false;
+          return e.value;
+        }
+      if (n.entries.size() < kBucket || s > kMaxShift)
+      {
+        n.entries.push_back(Entry{ h, key, V{} });
+        ++size_;
+        if (inserted)
+          *inserted = true;
+        return n.entries.back().value;
+      }
+      // full bucket: split into an inner node and retry one level down
+      n.children.resize(kWidth);
+      for (auto& e : n.entries)
+      {
+        auto& child = n.children[(e.hash >> s) & (kWidth - 1)];
+        own(child);
+        child->entries.push_back(std::move(e));
+      }
+      std::vector<Entry>().swap(n.entries);
+    }
+  }
+
+private:
+  static uint64_t hash(const K& key)
+  {
+    return mix64(static_cast<uint64_t>(Hash{}(key)));
+  }
+
+  void own(std::shared_ptr<Node>& slot)
+  {
+    if (!slot)
+    {
+      slot = std::make_shared<Node>();
+      slot->owner = owner_;
+    }
+    else if (slot->owner != owner_)
+    {
+      slot = std::make_shared<Node>(*slot);
+      slot->owner = owner_;
+    }
+  }
+
+  std::shared_ptr<Node> root_;
+  size_t size_{ 0 };
+  mutable uint64_t owner_{ detail::next_persistent_owner() };
+};
+
+}  // namespace nano_graphrag
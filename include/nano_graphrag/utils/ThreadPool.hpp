@@ -0,0 +1,160 @@
+#pragma once
+
+#include <condition_variable>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nano_graphrag/utils/Parallel.hpp"
+
+namespace nano_graphrag
+{
+
+/**
+ * @brief Fixed-size pool of worker threads executing queued tasks in FIFO order.
+ *
+ * `submit` returns a `std::future` for the task's result; exceptions thrown by a
+ * task are delivered through that future. The destructor drains the queue and
+ * joins the workers.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Start the workers.
+   * @param num_threads Worker count; 0 means `hardware_threads()`.
+   */
+  explicit ThreadPool(size_t num_threads = 0)
+  {
+    if (num_threads == 0)
+      num_threads = hardware_threads();
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i)
+      workers_.emplace_back([this]() { run(); });
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_)
+      w.join();
+  }
+
+  /**
+   * @brief Queue a callable and get a future for its result.
+   */
+  template <typename Fn>
+  auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>
+  {
+    using R = std::invoke_result_t<std::decay_t<Fn>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Fn>(fn));
+    auto fut = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.emplace([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return fut;
+  }
+
+  /** Number of worker threads. */
+  size_t size() const
+  {
+    return workers_.size();
+  }
+
+private:
+  void run()
+  {
+    for (;;)
+    {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+          return;  // stopping and drained
+        job = std::move(queue_.front());
+        queue_.pop();
+      }
+      job();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_{ false };
+};
+
+/**
+ * @brief `parallel_for` on the workers of a pool instead of freshly spawned threads.
+ *
+ * Splits `[begin, end)` into at most `pool.size()` contiguous ranges with dense
+ * indices `tid`; the calling thread runs range 0 and waits for the rest. The
+ * first exception thrown by any range is rethrown once all ranges are done.
+ * Must not be called from one of the pool's own workers.
+ *
+ * @return Number of ranges actually used.
+ */
+template <typename Fn>
+inline size_t parallel_for(ThreadPool& pool, size_t begin, size_t end, Fn&& fn)
+{
+  if (end <= begin)
+    return 0;
+  size_t n = end - begin;
+  size_t ranges = std::min(std::max<size_t>(pool.size(), 1), n);
+  size_t step = (n + ranges - 1) / ranges;
+  ranges = (n + step - 1) / step;
+  std::vector<std::future<void>> pending;
+  pending.reserve(ranges - 1);
+  for (size_t t = 1; t < ranges; ++t)
+  {
+    size_t lo = begin + t * step;
+    size_t hi = std::min(end, lo + step);
+    pending.push_back(pool.submit([&fn, lo, hi, t]() { fn(lo, hi, t); }));
+  }
+  std::exception_ptr error;
+  try
+  {
+    fn(begin, std::min(end, begin + step), size_t{ 0 });
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  for (auto& f : pending)
+  {
+    try
+    {
+      f.get();
+    }
+    catch (...)
+    {
+      if (!error)
+        error = std::current_exception();
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+  return ranges;
+}
+
+}  // namespace nano_graphrag
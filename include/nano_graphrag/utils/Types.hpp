@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 namespace nano_graphrag
 {
@@ -15,6 +16,7 @@ struct TextChunk
   std::string content;
   std::string full_doc_id;
   int chunk_order_index{ 0 };
+  std::string duplicate_of;  // id of a near-duplicate chunk already indexed, if any
 };
 
 // nlohmann::json serialization for TextChunk (free functions)
@@ -24,6 +26,8 @@ inline void to_json(nlohmann::json& j, const TextChunk& c)
                       { "content", c.content },
                       { "full_doc_id", c.full_doc_id },
                       { "chunk_order_index", c.chunk_order_index } };
+  if (!c.duplicate_of.empty())
+    j["duplicate_of"] = c.duplicate_of;
 }
 
 inline void from_json(const nlohmann::json& j, TextChunk& c)
@@ -32,6 +36,7 @@ inline void from_json(const nlohmann::json& j, TextChunk& c)
   j.at("content").get_to(c.content);
   j.at("full_doc_id").get_to(c.full_doc_id);
   j.at("chunk_order_index").get_to(c.chunk_order_index);
+  c.duplicate_of = j.value("duplicate_of", std::string{});
 }
 
 struct SingleCommunity
@@ -105,4 +110,48 @@ struct QueryParam
                                                                                           "json_object" } };
 };
 
+/**
+ * @brief Limits for a batched k-hop neighborhood lookup (`BaseGraphStorage::get_subgraph`).
+ *
+ * A value of 0 for any of the `max_*` budgets means "unlimited".
+ */
+struct SubgraphParam
+{
+  int max_hops{ 1 };                // expand this many hops out from the seeds
+  int max_neighbors_per_node{ 0 };  // keep only the highest-ranked neighbors of each expanded node
+  int max_nodes{ 0 };               // total node budget (seeds included)
+  int max_edges{ 0 };               // total edge budget
+  bool with_properties{ true };     // copy node/edge property maps into the result
+  bool rank_by_centrality{ false };  // rank by PageRank where the storage computes it, else by degree
+};
+
+/**
+ * @brief Flat k-hop subgraph around a seed set.
+ *
+ * Nodes are listed seeds first, then in expansion order; edges are undirected
+ * and refer to their endpoints by index into `nodes`.
+ */
+struct Subgraph
+{
+  struct Node
+  {
+    std::string id;
+    int degree{ 0 };
+    int hop{ 0 };
+    double rank{ 0.0 };  // expansion order key: degree, or PageRank with `rank_by_centrality`
+    std::unordered_map<std::string, std::string> properties;
+  };
+
+  struct Edge
+  {
+    int source{ 0 };
+    int target{ 0 };
+    int degree{ 0 };  // sum of endpoint degrees, as in `edge_degree`
+    std::unordered_map<std::string, std::string> properties;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<Edge> edges;
+};
+
 }  // namespace nano_graphrag
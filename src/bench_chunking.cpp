@@ -0,0 +1,177 @@
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nano_graphrag/operations/chunking/default.hpp"
+#include "nano_graphrag/operations/chunking/streaming.hpp"
+#include "nano_graphrag/operations/tokenize/factory.hpp"
+#include "nano_graphrag/utils/Parallel.hpp"
+
+// Benchmark for DefaultChunkingStrategy::get_chunks() across thread counts.
+// Usage: bench_chunking [megabytes=16] [docs=2000] [tokenizer=simple|tiktoken]
+// A synthetic corpus of `docs` documents totalling roughly `megabytes` MB is
+// chunked with 1, 2, 4, ... hardware threads; every parallel run is checked
+// against the sequential output. A final single-threaded run with offset mode
+// disabled shows the cost of copying and decoding token windows. Last, the corpus
+// is re-chunked at a different size from a freshly opened TokenCache file, which
+// skips the tokenizer, and compared against re-chunking from scratch. Finally a
+// document of short lines and blank lines is fed to StreamingChunker in small
+// blocks and must give exactly the whole-document chunks.
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+  size_t num_docs = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+  std::string tokenizer_name = argc > 3 ? argv[3] : "simple";
+  if (num_docs == 0)
+    num_docs = 1;
+
+  static const char* kWords[] = { "graph",   "retrieval", "community", "entity",  "relation", "the",
+                                  "of",      "and",       "summary",   "node",    "edge",     "a",
+                                  "context", "query",     "document",  "chunk",   "token",    "model",
+                                  "global",  "local",     "report",    "cluster", "weight",   "source" };
+  const size_t num_words = sizeof(kWords) / sizeof(kWords[0]);
+  uint64_t rng = 0x9E3779B97F4A7C15ull;
+  auto next = [&rng]() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+  };
+
+  std::unordered_map<std::string, std::unordered_map<std::string, std::string>> docs;
+  const size_t doc_bytes = megabytes * 1024 * 1024 / num_docs;
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < num_docs; ++i)
+  {
+    std::string text;
+    text.reserve(doc_bytes + 16);
+    while (text.size() < doc_bytes)
+    {
+      text += kWords[next() % num_words];
+      text += (next() % 12 == 0) ? ".\n" : " ";
+    }
+    total_bytes += text.size();
+    docs["doc-" + std::to_string(i)] = { { "content", std::move(text) } };
+  }
+
+  auto tokenizer = create_tokenizer_strategy(tokenizer_name == "tiktoken" ? TokenizerType::Tiktoken
+                                                                          : TokenizerType::Simple);
+  std::shared_ptr<ITokenizerStrategy> shared_tokenizer(std::move(tokenizer));
+  DefaultChunkingStrategy chunker;
+  chunker.set_tokenizer(shared_tokenizer);
+  std::cout << "docs=" << num_docs << " bytes=" << total_bytes << " tokenizer=" << tokenizer_name << "\n";
+
+  std::vector<size_t> thread_counts{ 1 };
+  for (size_t t = 2; t < hardware_threads(); t *= 2)
+    thread_counts.push_back(t);
+  if (hardware_threads() > 1)
+    thread_counts.push_back(hardware_threads());
+
+  std::unordered_map<std::string, TextChunk> baseline;
+  double baseline_ms = 0.0;
+  for (size_t threads : thread_counts)
+  {
+    chunker.set_num_threads(threads);
+    auto start = std::chrono::steady_clock::now();
+    auto chunks = chunker.get_chunks(docs, 128, 1024);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    bool same = true;
+    if (threads == 1)
+    {
+      baseline = chunks;
+      baseline_ms = ms;
+    }
+    else
+    {
+      same = chunks.size() == baseline.size();
+      for (auto it = chunks.begin(); same && it != chunks.end(); ++it)
+      {
+        auto b = baseline.find(it->first);
+        same = b != baseline.end() && b->second.full_doc_id == it->second.full_doc_id &&
+               b->second.chunk_order_index == it->second.chunk_order_index;
+      }
+    }
+    std::cout << "threads=" << threads << " chunks=" << chunks.size() << " time (ms): " << ms
+              << " MB/s: " << (total_bytes / (1024.0 * 1024.0)) / (ms / 1000.0)
+              << " speedup: " << baseline_ms / ms << (same ? "" : " MISMATCH") << "\n";
+  }
+
+  chunker.set_num_threads(1);
+  chunker.set_offset_mode(false);
+  auto start = std::chrono::steady_clock::now();
+  auto decoded = chunker.get_chunks(docs, 128, 1024);
+  auto end = std::chrono::steady_clock::now();
+  double ms = std::chrono::duration<double, std::milli>(end - start).count();
+  std::cout << "decode mode threads=1 chunks=" << decoded.size() << " time (ms): " << ms
+            << " MB/s: " << (total_bytes / (1024.0 * 1024.0)) / (ms / 1000.0) << "\n";
+
+  chunker.set_offset_mode(true);
+  const std::string cache_path =
+      (std::filesystem::temp_directory_path() / "bench_chunking_token_cache.bin").string();
+  std::filesystem::remove(cache_path);
+  const std::string name = shared_tokenizer->name();
+  chunker.set_token_cache(std::make_shared<TokenCache>(cache_path, name));
+  chunker.get_chunks(docs, 128, 1024);
+  chunker.token_cache()->flush();
+
+  chunker.set_token_cache(nullptr);
+  start = std::chrono::steady_clock::now();
+  auto fresh = chunker.get_chunks(docs, 64, 512);
+  end = std::chrono::steady_clock::now();
+  double fresh_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+  start = std::chrono::steady_clock::now();
+  chunker.set_token_cache(std::make_shared<TokenCache>(cache_path, name));
+  auto cached = chunker.get_chunks(docs, 64, 512);
+  end = std::chrono::steady_clock::now();
+  double cached_ms = std::chrono::duration<double, std::milli>(end - start).count();
+  bool same = cached.size() == fresh.size();
+  for (auto it = cached.begin(); same && it != cached.end(); ++it)
+  {
+    auto f = fresh.find(it->first);
+    same = f != fresh.end() && f->second.tokens == it->second.tokens;
+  }
+  std::cout << "re-chunk 512/64 tokenizing (ms): " << fresh_ms << " from token cache (ms): " << cached_ms
+            << " cache file bytes: " << std::filesystem::file_size(cache_path)
+            << " speedup: " << fresh_ms / cached_ms << (same ? "" : " MISMATCH") << "\n";
+  std::filesystem::remove(cache_path);
+
+  // Streaming in 512-byte blocks cuts the document many times, often next to line breaks
+  chunker.set_token_cache(nullptr);
+  std::string sample;
+  while (sample.size() < 256 * 1024)
+  {
+    sample += kWords[next() % num_words];
+    const uint64_t r = next() % 8;
+    sample += r == 0 ? ".\n\n" : r == 1 ? "\n" : r == 2 ? ",\n" : " ";
+  }
+  auto whole = chunker.get_chunks({ { "doc-0", { { "content", sample } } } }, 128, 1024);
+  std::vector<const TextChunk*> expected(whole.size(), nullptr);
+  for (const auto& kv : whole)
+    if (static_cast<size_t>(kv.second.chunk_order_index) < expected.size())
+      expected[static_cast<size_t>(kv.second.chunk_order_index)] = &kv.second;
+  StreamingChunker streaming(shared_tokenizer, 1024, 128, 512);
+  std::istringstream in(sample);
+  size_t index = 0;
+  same = true;
+  size_t streamed = streaming.chunk_stream(in, "doc-0", [&](TextChunk&& chunk) {
+    const TextChunk* e = index < expected.size() ? expected[index] : nullptr;
+    same = same && e && e->content == chunk.content && e->tokens == chunk.tokens;
+    ++index;
+  });
+  same = same && streamed == whole.size();
+  std::cout << "streaming vs whole document: chunks=" << streamed << (same ? " same" : " MISMATCH") << "\n";
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "nano_graphrag/storage/GraphStorage.hpp"
+#include "nano_graphrag/utils/Parallel.hpp"
+
+// Benchmark for InMemoryGraphStorage::community_schema() on a random graph.
+// Usage: bench_community_schema [nodes=1000000] [edges=5000000] [communities=1000]
+// Edges stay inside one of `communities` node blocks so the schema has many
+// communities; timings are reported for 1 thread and for all hardware threads.
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t num_nodes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  size_t num_edges = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000000;
+  size_t num_blocks = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+  if (num_blocks == 0 || num_blocks > num_nodes)
+    num_blocks = 1;
+  size_t block_size = num_nodes / num_blocks;
+
+  std::cout << "nodes=" << num_nodes << " edges=" << num_edges << " communities=" << num_blocks << "\n";
+
+  InMemoryGraphStorage graph("bench");
+  auto start_build = std::chrono::steady_clock::now();
+  {
+    std::vector<std::pair<std::string, std::unordered_map<std::string, std::string>>> nodes;
+    nodes.reserve(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i)
+      nodes.emplace_back("n" + std::to_string(i), std::unordered_map<std::string, std::string>{});
+    graph.upsert_nodes_batch(nodes);
+  }
+  uint64_t rng = 0x9E3779B97F4A7C15ull;
+  auto next = [&rng]() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+  };
+  const size_t batch = 1000000;
+  std::vector<std::tuple<std::string, std::string, std::unordered_map<std::string, std::string>>> edges;
+  for (size_t done = 0; done < num_edges; done += batch)
+  {
+    edges.clear();
+    for (size_t i = done; i < std::min(num_edges, done + batch); ++i)
+    {
+      size_t block = next() % num_blocks;
+      size_t a = block * block_size + next() % block_size;
+      size_t b = block * block_size + next() % block_size;
+      edges.emplace_back("n" + std::to_string(a), "n" + std::to_string(b),
+                         std::unordered_map<std::string, std::string>{});
+    }
+    graph.upsert_edges_batch(edges);
+  }
+  graph.clustering("connected_components");
+  auto end_build = std::chrono::steady_clock::now();
+  std::cout << "Build + clustering time (ms): "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end_build - start_build).count() << "\n";
+
+  std::vector<size_t> thread_counts{ 1 };
+  if (hardware_threads() > 1)
+    thread_counts.push_back(hardware_threads());
+  for (size_t threads : thread_counts)
+  {
+    graph.set_analytics_threads(threads);
+    auto start = std::chrono::steady_clock::now();
+    auto schema = graph.community_schema();
+    auto end = std::chrono::steady_clock::now();
+    size_t total_edges = 0;
+    for (const auto& kv : schema)
+      total_edges += kv.second.edges.size();
+    std::cout << "threads=" << threads << " communities=" << schema.size() << " edges=" << total_edges
+              << " community_schema time (ms): "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "\n";
+  }
+  return 0;
+}
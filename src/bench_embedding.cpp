@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+
+#include "nano_graphrag/embedding/openai.hpp"
+
+// Benchmark for OpenAIEmbeddingStrategy::embed() request concurrency.
+// Usage: bench_embedding [texts=2048] [latency_ms=100] [dim=256] [inputs_per_request=64]
+// A local stand-in for /v1/embeddings answers every request after `latency_ms`
+// with deterministic vectors. `texts` inputs are embedded with 1, 4 and 16
+// requests in flight; each run is checked for input order. A final run with a
+// timeout shorter than the latency must fail.
+
+namespace
+{
+
+std::atomic<int> g_latency_ms{ 100 };
+std::atomic<int> g_dim{ 256 };
+
+class FakeEmbeddingHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+  void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override
+  {
+    Poco::JSON::Parser parser;
+    auto body = parser.parse(request.stream()).extract<Poco::JSON::Object::Ptr>();
+    auto inputs = body->getArray("input");
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_latency_ms.load()));
+
+    // embedding[0] carries the input's leading number so the client can check ordering
+    std::ostringstream out;
+    out << "{\"object\":\"list\",\"data\":[";
+    for (size_t i = 0; i < inputs->size(); ++i)
+    {
+      std::string text = inputs->getElement<std::string>(i);
+      out << (i ? "," : "") << "{\"object\":\"embedding\",\"index\":" << i << ",\"embedding\":["
+          << std::atoi(text.c_str());
+      for (int d = 1; d < g_dim.load(); ++d)
+        out << ",0.001";
+      out << "]}";
+    }
+    out << "],\"model\":\"stand-in\"}";
+    const std::string payload = out.str();
+    response.setContentType("application/json");
+    response.setContentLength(static_cast<std::streamsize>(payload.size()));
+    response.send() << payload;
+  }
+};
+
+class FakeEmbeddingFactory : public Poco::Net::HTTPRequestHandlerFactory
+{
+public:
+  Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) override
+  {
+    return new FakeEmbeddingHandler;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t num_texts = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+  g_latency_ms = argc > 2 ? std::atoi(argv[2]) : 100;
+  g_dim = argc > 3 ? std::atoi(argv[3]) : 256;
+  size_t per_request = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 64;
+
+  Poco::Net::ServerSocket socket(0);
+  Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+  params->setMaxThreads(32);
+  params->setMaxQueued(256);
+  Poco::Net::HTTPServer server(new FakeEmbeddingFactory, socket, params);
+  server.start();
+  const std::string endpoint = "http://127.0.0.1:" + std::to_string(server.port()) + "/v1/embeddings";
+
+  std::vector<std::string> texts;
+  texts.reserve(num_texts);
+  for (size_t i = 0; i < num_texts; ++i)
+    texts.push_back(std::to_string(i) + " graph retrieval community summary");
+  std::cout << "texts=" << num_texts << " latency_ms=" << g_latency_ms << " dim=" << g_dim
+            << " inputs_per_request=" << per_request << " endpoint=" << endpoint << "\n";
+
+  double serial_ms = 0.0;
+  for (size_t in_flight : { 1, 4, 16 })
+  {
+    OpenAIEmbeddingStrategy emb(static_cast<size_t>(g_dim.load()));
+    emb.set_endpoint(endpoint);
+    emb.set_request_limits(per_request, 300000);
+    emb.set_max_in_flight(in_flight);
+    auto start = std::chrono::steady_clock::now();
+    auto vectors = emb.embed(texts);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if (in_flight == 1)
+      serial_ms = ms;
+    bool ordered = vectors.size() == texts.size();
+    for (size_t i = 0; ordered && i < vectors.size(); ++i)
+      ordered = !vectors[i].empty() && static_cast<size_t>(vectors[i][0]) == i;
+    std::cout << "in_flight=" << in_flight << " time (ms): " << ms
+              << " texts/s: " << texts.size() / (ms / 1000.0) << " speedup: " << serial_ms / ms
+              << (ordered ? "" : " MISORDERED") << "\n";
+  }
+
+  OpenAIEmbeddingStrategy emb(static_cast<size_t>(g_dim.load()));
+  emb.set_endpoint(endpoint);
+  emb.set_request_timeout(std::chrono::milliseconds(std::max(1, g_latency_ms.load() / 4)));
+  try
+  {
+    emb.embed({ "0 timeout probe" });
+    std::cout << "timeout: request unexpectedly succeeded\n";
+  }
+  catch (const std::exception& e)
+  {
+    std::cout << "timeout: request failed as expected (" << e.what() << ")\n";
+  }
+
+  server.stop();
+  return 0;
+}
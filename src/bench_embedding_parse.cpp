@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Parser.h>
+
+#include "nano_graphrag/embedding/response_parser.hpp"
+
+// Benchmark for decoding /v1/embeddings response bodies.
+// Usage: bench_embedding_parse [embeddings=1000] [dim=1536] [iters=10]
+// Builds a local fixture response in both wire formats (JSON number arrays and
+// base64 float32) and reports the decode cost per 1k embeddings for the Poco
+// DOM path, the DOM-free scanner on number arrays, and the scanner on base64.
+
+namespace
+{
+
+std::string base64_encode(const unsigned char* data, size_t size)
+{
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((size + 2) / 3 * 4);
+  for (size_t i = 0; i < size; i += 3)
+  {
+    const uint32_t n = (static_cast<uint32_t>(data[i]) << 16) |
+                       (i + 1 < size ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+                       (i + 2 < size ? static_cast<uint32_t>(data[i + 2]) : 0);
+    out.push_back(alphabet[(n >> 18) & 0x3F]);
+    out.push_back(alphabet[(n >> 12) & 0x3F]);
+    out.push_back(i + 1 < size ? alphabet[(n >> 6) & 0x3F] : '=');
+    out.push_back(i + 2 < size ? alphabet[n & 0x3F] : '=');
+  }
+  return out;
+}
+
+// Response shaped like the API's: one object per input with "object", "index" and "embedding"
+std::string make_response(const std::vector<std::vector<float>>& vectors, bool base64)
+{
+  std::string out = "{\"object\":\"list\",\"data\":[";
+  char num[32];
+  for (size_t i = 0; i < vectors.size(); ++i)
+  {
+    out += i ? ",\n" : "\n";
+    out += "{\"object\":\"embedding\",\"index\":" + std::to_string(i) + ",\"embedding\":";
+    if (base64)
+    {
+      out += '"';
+      out += base64_encode(reinterpret_cast<const unsigned char*>(vectors[i].data()),
+                           vectors[i].size() * sizeof(float));
+      out += '"';
+    }
+    else
+    {
+      out += '[';
+      for (size_t d = 0; d < vectors[i].size(); ++d)
+      {
+        std::snprintf(num, sizeof(num), "%s%.9g", d ? "," : "", vectors[i][d]);
+        out += num;
+      }
+      out += ']';
+    }
+    out += '}';
+  }
+  out += "],\"model\":\"text-embedding-3-small\",\"usage\":{\"prompt_tokens\":0,\"total_tokens\":0}}";
+  return out;
+}
+
+// The decode path used before the scanner: Poco DOM, then an index-ordered map
+std::vector<std::vector<float>> parse_with_poco(const std::string& body, size_t rows)
+{
+  Poco::JSON::Parser parser;
+  auto response = parser.parse(body).extract<Poco::JSON::Object::Ptr>();
+  auto data = response->getArray("data");
+  std::map<size_t, std::vector<float>> ordered;
+  for (size_t i = 0; i < data->size(); ++i)
+  {
+    auto item = data->getObject(i);
+    auto emb = item->getArray("embedding");
+    std::vector<float> vec;
+    vec.reserve(emb->size());
+    for (size_t j = 0; j < emb->size(); ++j)
+      vec.push_back(static_cast<float>(emb->get(j).convert<double>()));
+    ordered[static_cast<size_t>(item->getValue<int>("index"))] = std::move(vec);
+  }
+  std::vector<std::vector<float>> result(rows);
+  for (auto& kv : ordered)
+    if (kv.first < rows)
+      result[kv.first] = std::move(kv.second);
+  return result;
+}
+
+bool same(const nano_graphrag::EmbeddingMatrix& r, const std::vector<std::vector<float>>& expected)
+{
+  if (r.rows != expected.size())
+    return false;
+  for (size_t i = 0; i < r.rows; ++i)
+    if (r.dim != expected[i].size() || std::memcmp(r.row(i), expected[i].data(), r.dim * sizeof(float)) != 0)
+      return false;
+  return true;
+}
+
+template <typename F>
+double time_ms(size_t iters, F&& f)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iters; ++i)
+    f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(iters);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+  size_t dim = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1536;
+  size_t iters = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10;
+
+  std::vector<std::vector<float>> vectors(count, std::vector<float>(dim));
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (auto& v : vectors)
+  {
+    for (auto& x : v)
+    {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      x = static_cast<float>(static_cast<int64_t>(state >> 33) - (1ll << 30)) / static_cast<float>(1ll << 35);
+    }
+  }
+  const std::string json_body = make_response(vectors, false);
+  const std::string b64_body = make_response(vectors, true);
+  std::cout << "embeddings=" << count << " dim=" << dim << " iters=" << iters << "\n"
+            << "payload float: " << json_body.size() / 1e6 << " MB, base64: " << b64_body.size() / 1e6
+            << " MB\n";
+
+  const double per_1k = 1000.0 / static_cast<double>(count);
+  EmbeddingMatrix parsed;
+  double poco_ms = time_ms(iters, [&] { parse_with_poco(json_body, count); });
+  std::cout << "poco dom (float):  " << poco_ms * per_1k << " ms per 1k embeddings\n";
+
+  double json_ms = time_ms(iters, [&] { parsed = parse_embedding_response(json_body, count); });
+  std::cout << "scanner (float):   " << json_ms * per_1k << " ms per 1k embeddings, speedup "
+            << poco_ms / json_ms << (same(parsed, vectors) ? "" : " MISMATCH") << "\n";
+
+  double b64_ms = time_ms(iters, [&] { parsed = parse_embedding_response(b64_body, count); });
+  std::cout << "scanner (base64):  " << b64_ms * per_1k << " ms per 1k embeddings, speedup "
+            << poco_ms / b64_ms << (same(parsed, vectors) ? "" : " MISMATCH") << "\n";
+  return 0;
+}
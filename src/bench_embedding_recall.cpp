@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "nano_graphrag/embedding/truncated.hpp"
+
+// Benchmark for serving embeddings at reduced (Matryoshka-truncated) dimension.
+// Usage: bench_embedding_recall [docs=20000] [queries=200] [dim=1536] [k=10]
+// Synthetic corpus: clustered vectors whose per-component energy decays with the
+// component index, as in Matryoshka-trained models. Queries are perturbed corpus
+// vectors. For each dimension the corpus and queries go through
+// TruncatedEmbeddingStrategy and a brute-force cosine scan; recall@k is measured
+// against the exact full-dimension top-k, alongside index memory and scan time.
+
+namespace
+{
+
+using RowMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Serves precomputed vectors; the text is the row number
+class TableEmbedding : public nano_graphrag::IEmbeddingStrategy
+{
+public:
+  explicit TableEmbedding(const RowMatrix& table) : table_(table)
+  {
+  }
+  std::vector<std::vector<float>> embed(const std::vector<std::string>& texts) const override
+  {
+    return embed_matrix(texts).to_vectors();
+  }
+  void embed_into(const std::vector<std::string>& texts, nano_graphrag::EmbeddingMatrix& out) const override
+  {
+    out.resize(texts.size(), embedding_dim());
+    for (size_t i = 0; i < texts.size(); ++i)
+    {
+      const auto r = static_cast<Eigen::Index>(std::strtoull(texts[i].c_str(), nullptr, 10));
+      std::copy_n(table_.row(r).data(), out.dim, out.row(i));
+    }
+  }
+  size_t embedding_dim() const override
+  {
+    return static_cast<size_t>(table_.cols());
+  }
+  size_t max_token_size() const override
+  {
+    return 8192;
+  }
+
+private:
+  const RowMatrix& table_;
+};
+
+RowMatrix to_matrix(const nano_graphrag::EmbeddingMatrix& m)
+{
+  return Eigen::Map<const RowMatrix>(m.values.data(), static_cast<Eigen::Index>(m.rows),
+                                     static_cast<Eigen::Index>(m.dim));
+}
+
+std::vector<std::vector<Eigen::Index>> top_k(const RowMatrix& index, const RowMatrix& queries, size_t k,
+                                             double& ms_per_query)
+{
+  std::vector<std::vector<Eigen::Index>> out(static_cast<size_t>(queries.rows()));
+  std::vector<Eigen::Index> order(static_cast<size_t>(index.rows()));
+  auto start = std::chrono::steady_clock::now();
+  for (Eigen::Index q = 0; q < queries.rows(); ++q)
+  {
+    Eigen::VectorXf scores = index * queries.row(q).transpose();  // unit vectors: dot = cosine
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = static_cast<Eigen::Index>(i);
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                      [&scores](Eigen::Index a, Eigen::Index b) { return scores[a] > scores[b]; });
+    out[static_cast<size_t>(q)].assign(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k));
+  }
+  auto end = std::chrono::steady_clock::now();
+  ms_per_query =
+      std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(queries.rows());
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t num_docs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+  size_t num_queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+  size_t full_dim = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1536;
+  size_t k = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10;
+  k = std::min(k, num_docs);
+
+  // component j carries energy ~ 1 / (1 + j / 64)^2: early components dominate
+  std::mt19937 rng(7);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<float> scale(full_dim);
+  for (size_t j = 0; j < full_dim; ++j)
+    scale[j] = 1.0f / (1.0f + static_cast<float>(j) / 64.0f);
+  const size_t num_clusters = std::max<size_t>(num_docs / 50, 1);
+  RowMatrix centers(static_cast<Eigen::Index>(num_clusters), static_cast<Eigen::Index>(full_dim));
+  for (Eigen::Index c = 0; c < centers.rows(); ++c)
+    for (size_t j = 0; j < full_dim; ++j)
+      centers(c, static_cast<Eigen::Index>(j)) = normal(rng) * scale[j];
+  auto sample = [&](const float* base, float noise, Eigen::Ref<Eigen::RowVectorXf> out) {
+    for (size_t j = 0; j < full_dim; ++j)
+      out[static_cast<Eigen::Index>(j)] = base[j] + noise * normal(rng) * scale[j];
+    out.normalize();
+  };
+  RowMatrix docs(static_cast<Eigen::Index>(num_docs), static_cast<Eigen::Index>(full_dim));
+  for (Eigen::Index i = 0; i < docs.rows(); ++i)
+    sample(centers.row(i % centers.rows()).data(), 0.8f, docs.row(i));
+  RowMatrix query_vectors(static_cast<Eigen::Index>(num_queries), static_cast<Eigen::Index>(full_dim));
+  for (Eigen::Index i = 0; i < query_vectors.rows(); ++i)
+    sample(docs.row((i * 7919) % docs.rows()).data(), 0.5f, query_vectors.row(i));
+
+  auto doc_source = std::make_shared<TableEmbedding>(docs);
+  auto query_source = std::make_shared<TableEmbedding>(query_vectors);
+  std::vector<std::string> doc_ids(num_docs), query_ids(num_queries);
+  for (size_t i = 0; i < num_docs; ++i)
+    doc_ids[i] = std::to_string(i);
+  for (size_t i = 0; i < num_queries; ++i)
+    query_ids[i] = std::to_string(i);
+
+  std::cout << "docs=" << num_docs << " queries=" << num_queries << " full_dim=" << full_dim << " k=" << k
+            << "\n";
+  std::vector<std::vector<Eigen::Index>> truth;
+  double full_ms = 0.0;
+  for (size_t dim : { full_dim, size_t{ 1024 }, size_t{ 768 }, size_t{ 512 }, size_t{ 256 }, size_t{ 128 },
+                      size_t{ 64 } })
+  {
+    if (dim > full_dim || (dim == full_dim && !truth.empty()))
+      continue;
+    TruncatedEmbeddingStrategy doc_emb(doc_source, dim);
+    TruncatedEmbeddingStrategy query_emb(query_source, dim);
+    RowMatrix index = to_matrix(doc_emb.embed_matrix(doc_ids));
+    RowMatrix queries = to_matrix(query_emb.embed_matrix(query_ids));
+    double ms = 0.0;
+    auto found = top_k(index, queries, k, ms);
+    if (truth.empty())
+    {
+      truth = found;
+      full_ms = ms;
+    }
+    size_t hits = 0;
+    for (size_t q = 0; q < found.size(); ++q)
+      for (Eigen::Index id : found[q])
+        hits += std::count(truth[q].begin(), truth[q].end(), id);
+    const double recall = static_cast<double>(hits) / static_cast<double>(found.size() * k);
+    std::cout << "dim=" << dim << " recall@" << k << ": " << recall
+              << " index (MB): " << static_cast<double>(index.size()) * sizeof(float) / 1e6
+              << " scan (ms/query): " << ms << " speedup: " << full_ms / ms << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Timespan.h>
+
+#include "nano_graphrag/interfaces/restapi.hpp"
+
+// Benchmark for RestClient connection reuse.
+// Usage: bench_restclient [requests=2000] [threads=4] [payload_bytes=2048]
+// A local keep-alive HTTP server answers every POST at once with a fixed JSON
+// payload. `threads` clients send `requests` POSTs in total, first opening a
+// session per request (no pool), then through an HTTPSessionPool; requests/sec,
+// mean latency and sessions opened are reported. A final round waits past the
+// server's keep-alive timeout so every pooled socket is stale, and must still
+// succeed by reconnecting.
+
+namespace
+{
+
+std::atomic<size_t> g_payload_bytes{ 2048 };
+
+class FixedHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+  void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override
+  {
+    // drain the body so the connection can serve the next request
+    std::istream& in = request.stream();
+    char buf[4096];
+    while (in.read(buf, sizeof(buf)) || in.gcount() > 0)
+    {
+    }
+    std::string payload = "{\"data\":\"";
+    payload.append(g_payload_bytes.load(), 'x');
+    payload += "\"}";
+    response.setContentType("application/json");
+    response.setContentLength(static_cast<std::streamsize>(payload.size()));
+    response.send() << payload;
+  }
+};
+
+class FixedFactory : public Poco::Net::HTTPRequestHandlerFactory
+{
+public:
+  Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) override
+  {
+    return new FixedHandler;
+  }
+};
+
+// Send `requests` POSTs from `threads` clients; returns wall time in ms, counts failures
+double run(const std::string& endpoint, const std::shared_ptr<nano_graphrag::HTTPSessionPool>& pool,
+           size_t requests, size_t threads, size_t& failures)
+{
+  std::atomic<size_t> next{ 0 };
+  std::atomic<size_t> failed{ 0 };
+  const std::string body = "{\"input\":\"ping\"}";
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&]() {
+      nano_graphrag::RestClient client;
+      client.set_session_pool(pool);
+      while (next.fetch_add(1) < requests)
+      {
+        try
+        {
+          if (client.post(body, endpoint).size() != g_payload_bytes.load() + 11)
+            ++failed;
+        }
+        catch (const std::exception& e)
+        {
+          if (failed.fetch_add(1) == 0)
+            std::cerr << "request failed: " << e.what() << "\n";
+        }
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  failures = failed.load();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t requests = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+  size_t threads = argc > 2 ? std::max<size_t>(std::strtoull(argv[2], nullptr, 10), 1) : 4;
+  g_payload_bytes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2048;
+
+  Poco::Net::ServerSocket socket(0);
+  Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+  params->setMaxThreads(static_cast<int>(threads * 2));
+  params->setMaxQueued(256);
+  params->setKeepAlive(true);
+  params->setMaxKeepAliveRequests(0);  // unlimited
+  params->setKeepAliveTimeout(Poco::Timespan(1, 0));
+  Poco::Net::HTTPServer server(new FixedFactory, socket, params);
+  server.start();
+  const std::string endpoint = "http://127.0.0.1:" + std::to_string(server.port()) + "/v1/echo";
+  std::cout << "requests=" << requests << " threads=" << threads << " payload_bytes=" << g_payload_bytes
+            << " endpoint=" << endpoint << "\n";
+
+  size_t failures = 0;
+  const double plain_ms = run(endpoint, nullptr, requests, threads, failures);
+  std::cout << "no pool: " << requests / (plain_ms / 1000.0) << " req/s, mean latency (ms): "
+            << plain_ms * static_cast<double>(threads) / static_cast<double>(requests)
+            << " sessions opened: " << requests << (failures ? " FAILURES: " + std::to_string(failures) : "")
+            << "\n";
+
+  auto pool = std::make_shared<HTTPSessionPool>(threads);
+  const double pooled_ms = run(endpoint, pool, requests, threads, failures);
+  std::cout << "pooled:  " << requests / (pooled_ms / 1000.0) << " req/s, mean latency (ms): "
+            << pooled_ms * static_cast<double>(threads) / static_cast<double>(requests)
+            << " sessions opened: " << pool->created() << " speedup: " << plain_ms / pooled_ms
+            << (failures ? " FAILURES: " + std::to_string(failures) : "") << "\n";
+
+  // the server drops idle keep-alive connections after 1 s; the pool still holds them
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  const size_t created_before = pool->created();
+  run(endpoint, pool, threads * 4, threads, failures);
+  std::cout << "stale sockets: " << (failures ? "FAILED (" + std::to_string(failures) + " errors)" : "ok")
+            << ", sessions reopened: " << pool->created() - created_before << "\n";
+
+  server.stop();
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "nano_graphrag/GraphRAG.hpp"
+#include "nano_graphrag/operations/tokenize/tiktoken_registry.hpp"
+
+// Benchmark for GraphRAG startup with the shared, lazily loaded tiktoken encoding.
+// Usage: bench_startup [working_dir_root=<temp dir>]
+// Reports constructor time for two GraphRAG instances, the latency of their first
+// encode (the first waits for the background load, the second reuses it), and the
+// cost of one eager GptEncoding::get_encoding call for comparison.
+
+namespace
+{
+
+double ms_since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  std::filesystem::path root =
+      argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path() / "bench_startup";
+  const std::string sample = "GraphRAG enables structured retrieval over knowledge graphs.";
+
+  auto start = std::chrono::steady_clock::now();
+  GraphRAG first((root / "a").string());
+  std::cout << "GraphRAG #1 constructor (ms): " << ms_since(start) << "\n";
+
+  start = std::chrono::steady_clock::now();
+  size_t tokens = first.tokenizer->count_tokens(sample);
+  std::cout << "GraphRAG #1 first encode (ms): " << ms_since(start) << " tokens=" << tokens << "\n";
+
+  start = std::chrono::steady_clock::now();
+  GraphRAG second((root / "b").string());
+  std::cout << "GraphRAG #2 constructor (ms): " << ms_since(start) << "\n";
+
+  start = std::chrono::steady_clock::now();
+  tokens = second.tokenizer->count_tokens(sample);
+  std::cout << "GraphRAG #2 first encode (ms): " << ms_since(start) << " tokens=" << tokens << "\n";
+
+  start = std::chrono::steady_clock::now();
+  auto eager = GptEncoding::get_encoding(LanguageModel::O200K_BASE);
+  std::cout << "eager GptEncoding::get_encoding (ms): " << ms_since(start) << "\n";
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "nano_graphrag/operations/tokenize/simple.hpp"
+#include "nano_graphrag/utils/ByteScan.hpp"
+
+// Benchmark for SimpleTokenizer's whitespace scan.
+// Usage: bench_tokenize [megabytes=256] [repeats=5]
+// Compares a byte-at-a-time reference loop with the vectorized word scan
+// (count_words / encode_offsets) and reports GB/s for each; results are
+// checked against the reference.
+
+namespace
+{
+
+std::vector<nano_graphrag::TokenOffset> reference_offsets(const std::string& text)
+{
+  std::vector<nano_graphrag::TokenOffset> out;
+  out.reserve(text.size() / 6);
+  size_t begin = 0;
+  bool in_word = false;
+  for (size_t i = 0; i < text.size(); ++i)
+  {
+    bool sep = nano_graphrag::is_word_separator(text[i]);
+    if (!sep && !in_word)
+      begin = i;
+    if (sep && in_word)
+      out.push_back({ begin, i });
+    in_word = !sep;
+  }
+  if (in_word)
+    out.push_back({ begin, text.size() });
+  return out;
+}
+
+template <typename Fn>
+double best_seconds(int repeats, Fn&& fn)
+{
+  double best = 1e30;
+  for (int r = 0; r < repeats; ++r)
+  {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace nano_graphrag;
+
+  size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+  if (repeats < 1)
+    repeats = 1;
+
+  static const char* kWords[] = { "graph", "retrieval", "of", "a", "community", "entity", "relation", "the" };
+  static const char* kSeps[] = { " ", " ", " ", "  ", "\n", "\t", ".\n\n" };
+  uint64_t rng = 0x9E3779B97F4A7C15ull;
+  auto next = [&rng]() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+  };
+  std::string text;
+  text.reserve(megabytes * 1024 * 1024 + 32);
+  while (text.size() < megabytes * 1024 * 1024)
+  {
+    text += kWords[next() % 8];
+    text += kSeps[next() % 7];
+  }
+  const double gb = text.size() / 1e9;
+  std::cout << "bytes=" << text.size() << " repeats=" << repeats << "\n";
+
+  std::vector<TokenOffset> expected;
+  double t_ref = best_seconds(repeats, [&]() { expected = reference_offsets(text); });
+  std::cout << "reference scan: " << gb / t_ref << " GB/s words=" << expected.size() << "\n";
+
+  size_t words = 0;
+  double t_count = best_seconds(repeats, [&]() { words = count_words(text); });
+  std::cout << "count_words: " << gb / t_count << " GB/s words=" << words
+            << (words == expected.size() ? "" : " MISMATCH") << "\n";
+
+  SimpleTokenizer tokenizer;
+  std::vector<TokenOffset> offsets;
+  double t_offsets = best_seconds(repeats, [&]() { offsets = tokenizer.encode_offsets(text); });
+  bool same = offsets.size() == expected.size();
+  for (size_t i = 0; same && i < offsets.size(); ++i)
+    same = offsets[i].begin == expected[i].begin && offsets[i].end == expected[i].end;
+  std::cout << "encode_offsets: " << gb / t_offsets << " GB/s words=" << offsets.size()
+            << (same ? "" : " MISMATCH") << "\n";
+  return 0;
+}
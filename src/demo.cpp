@@ -14,17 +14,16 @@ int main(int argc, char** argv)
 
   const char* api_key = std::getenv("OPENAI_API_KEY");
 
-  // Setup strategies
-    if (!api_key)
-    {
-      std::cerr << "ERROR: OPENAI_API_KEY not set. Please provide a valid API key for semantic retrieval." << std::endl;
-      return 1;
-    }
-    std::unique_ptr<nano_graphrag::IEmbeddingStrategy> emb_up = nano_graphrag::create_embedding_strategy(nano_graphrag::EmbeddingStrategyType::OpenAI);
-    std::shared_ptr<nano_graphrag::IEmbeddingStrategy> emb(std::move(emb_up));
-    rag.set_embedding_strategy(emb);
+  // Setup strategies: without an API key, fall back to offline local embeddings
+  if (!api_key)
+    std::cerr << "OPENAI_API_KEY not set: offline local embeddings, context-only answers." << std::endl;
+  std::unique_ptr<nano_graphrag::IEmbeddingStrategy> emb_up = nano_graphrag::create_embedding_strategy(
+      api_key ? nano_graphrag::EmbeddingStrategyType::OpenAI : nano_graphrag::EmbeddingStrategyType::Local);
+  std::shared_ptr<nano_graphrag::IEmbeddingStrategy> emb(std::move(emb_up));
+  rag.set_embedding_strategy(emb);
 
   // LLM strategy is optional for context-only mode. If API key is present, set it up.
+  if (api_key)
   {
     auto llm_up = nano_graphrag::create_llm_strategy(nano_graphrag::LLMStrategyType::OpenAI);
     std::shared_ptr<nano_graphrag::ILLMStrategy> llm(std::move(llm_up));
@@ -2,7 +2,6 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -11,14 +10,6 @@
 #include "nano_graphrag/llm/factory.hpp"
 #include "nano_graphrag/utils/Types.hpp"
 
-static std::string read_file(const std::string& path)
-{
-  std::ifstream ifs(path);
-  std::stringstream buffer;
-  buffer << ifs.rdbuf();
-  return buffer.str();
-}
-
 int main(int argc, char** argv)
 {
   using namespace nano_graphrag;
@@ -34,16 +25,16 @@ int main(int argc, char** argv)
 
   GraphRAG rag("./nano_cache");
 
-  // Strategies
+  // Strategies: without an API key, run offline with local embeddings and context-only answers,
+  // which still exercises chunking, storage and retrieval end to end
   if (!api_key)
-  {
-    std::cerr << "ERROR: OPENAI_API_KEY not set. Please provide a valid API key for semantic retrieval." << std::endl;
-    return 1;
-  }
-  std::unique_ptr<IEmbeddingStrategy> emb_up = create_embedding_strategy(EmbeddingStrategyType::OpenAI);
+    std::cerr << "OPENAI_API_KEY not set: offline local embeddings, context-only answers." << std::endl;
+  std::unique_ptr<IEmbeddingStrategy> emb_up =
+      create_embedding_strategy(api_key ? EmbeddingStrategyType::OpenAI : EmbeddingStrategyType::Local);
   std::shared_ptr<IEmbeddingStrategy> emb(std::move(emb_up));
   rag.set_embedding_strategy(emb);
 
+  if (api_key)
   {
     auto llm_up = create_llm_strategy(LLMStrategyType::OpenAI);
     std::shared_ptr<ILLMStrategy> llm(std::move(llm_up));
@@ -54,13 +45,13 @@ int main(int argc, char** argv)
 
   // Indexing
   auto start_index = std::chrono::steady_clock::now();
-  std::string corpus = read_file(data_path);
-  // simple paragraph split on blank lines
+  // simple paragraph split on blank lines; every paragraph is kept in memory for one batched
+  // insert (GraphRAG::insert_stream chunks a single large document without buffering it)
   std::vector<std::string> docs;
   {
-    std::stringstream ss(corpus);
+    std::ifstream ifs(data_path);
     std::string line, para;
-    while (std::getline(ss, line))
+    while (std::getline(ifs, line))
     {
       if (line.empty())
       {